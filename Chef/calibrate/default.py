@@ -1,93 +1,17 @@
 #!/usr/bin/env python
 #
 
+from chef import calibrate_probe
 from chef import symbex
 
 def calibrate():
-    x = 0
-    y = 1
-    symbex.calibrate(1, 0)
-    x = x + y
-    y = x + y
-    x = x * 2
-    y = y / 2
-    symbex.calibrate(1, 5)
-    x = x + y
-    y = x + y
-    x = x * 2
-    y = y / 2
-    symbex.calibrate(1, 5)
-    x = x + y
-    y = x + y
-    x = x * 2
-    y = y / 2
-    symbex.calibrate(1, 5)
-    x = x + y
-    y = x + y
-    x = x * 2
-    y = y / 2
-    symbex.calibrate(1, 5)
-    x = x + y
-    y = x + y
-    x = x * 2
-    y = y / 2
-    symbex.calibrate(1, 5)
-    x = x + y
-    y = x + y
-    x = x * 2
-    y = y / 2
-    symbex.calibrate(1, 5)
-    x = x + y
-    y = x + y
-    x = x * 2
-    y = y / 2
-    symbex.calibrate(1, 5)
-    x = x + y
-    y = x + y
-    x = x * 2
-    y = y / 2
-    symbex.calibrate(1, 5)
-    x = x + y
-    y = x + y
-    x = x * 2
-    y = y / 2
-    symbex.calibrate(1, 5)
-    x = x + y
-    y = x + y
-    x = x * 2
-    y = y / 2
-    symbex.calibrate(1, 5)
-    x = x + y
-    y = x + y
-    x = x * 2
-    y = y / 2
-    symbex.calibrate(1, 5)
-    x = x + y
-    y = x + y
-    x = x * 2
-    y = y / 2
-    symbex.calibrate(1, 5)
-    x = x + y
-    y = x + y
-    x = x * 2
-    y = y / 2
-    symbex.calibrate(1, 5)
-    x = x + y
-    y = x + y
-    x = x * 2
-    y = y / 2
-    symbex.calibrate(1, 5)
-    x = x + y
-    y = x + y
-    x = x * 2
-    y = y / 2
-    symbex.calibrate(1, 5)
+    calibrate_probe.run()
 
 
 def main():
-    symbex.calibrate(0)
+    symbex.calibrate(0, calibrate_probe.PROBE_ID)
     calibrate()
-    symbex.calibrate(2)
+    symbex.calibrate(2, calibrate_probe.PROBE_ID)
 
 
 if __name__ == "__main__":
@@ -3,103 +3,38 @@
 # Copyright 2015 EPFL. All rights reserved.
 
 
-"""Interpreter detector calibration."""
+"""Interpreter detector calibration.
+
+The probe in calibrate_probe is generated by Chef/utils/gen_calibration_probe.py
+from Include/opcode.h.  The host keeps the calibration results, keyed by the
+probe, the interpreter build and the symbolic optimization flags, so that
+later runs of the same interpreter skip the probe.
+"""
 
 
 __author__ = "stefan.bucur@epfl.ch (Stefan Bucur)"
 
 
 from chef import symbex
+from chef import calibrate_probe
 
 
 class CalibrationOp(object):
     START = 0
     CHECKPOINT = 1
     END = 2
+    LOAD = 3
 
 
-def _sub_calibrate():
-    x = 0
-    y = 1
-    symbex.calibrate(CalibrationOp.CHECKPOINT, 0)
-    x += y
-    y += y
-    x *= 2
-    y /= 2
-    symbex.calibrate(CalibrationOp.CHECKPOINT, 5)
-    x += y
-    y += y
-    x *= 2
-    y /= 2
-    symbex.calibrate(CalibrationOp.CHECKPOINT, 5)
-    x += y
-    y += y
-    x *= 2
-    y /= 2
-    symbex.calibrate(CalibrationOp.CHECKPOINT, 5)
-    x += y
-    y += y
-    x *= 2
-    y /= 2
-    symbex.calibrate(CalibrationOp.CHECKPOINT, 5)
-    x += y
-    y += y
-    x *= 2
-    y /= 2
-    symbex.calibrate(CalibrationOp.CHECKPOINT, 5)
-    x += y
-    y += y
-    x *= 2
-    y /= 2
-    symbex.calibrate(CalibrationOp.CHECKPOINT, 5)
-    x += y
-    y += y
-    x *= 2
-    y /= 2
-    symbex.calibrate(CalibrationOp.CHECKPOINT, 5)
-    x += y
-    y += y
-    x *= 2
-    y /= 2
-    symbex.calibrate(CalibrationOp.CHECKPOINT, 5)
-    x += y
-    y += y
-    x *= 2
-    y /= 2
-    symbex.calibrate(CalibrationOp.CHECKPOINT, 5)
-    x += y
-    y += y
-    x *= 2
-    y /= 2
-    symbex.calibrate(CalibrationOp.CHECKPOINT, 5)
-    x += y
-    y += y
-    x *= 2
-    y /= 2
-    symbex.calibrate(CalibrationOp.CHECKPOINT, 5)
-    x += y
-    y += y
-    x *= 2
-    y /= 2
-    symbex.calibrate(CalibrationOp.CHECKPOINT, 5)
-    x += y
-    y += y
-    x *= 2
-    y /= 2
-    symbex.calibrate(CalibrationOp.CHECKPOINT, 5)
-    x += y
-    y += y
-    x *= 2
-    y /= 2
-    symbex.calibrate(CalibrationOp.CHECKPOINT, 5)
-    x += y
-    y += y
-    x *= 2
-    y /= 2
-    symbex.calibrate(CalibrationOp.CHECKPOINT, 5)
+def perform_calibration(use_cache=True):
+    """Calibrates the interpreter detector, unless the host has the results
+    of an earlier calibration.  Returns True if the probe ran."""
 
+    if use_cache and symbex.calibrate(CalibrationOp.LOAD,
+                                      calibrate_probe.PROBE_ID):
+        return False
 
-def perform_calibration():
-    symbex.calibrate(CalibrationOp.START)
-    _sub_calibrate()
-    symbex.calibrate(CalibrationOp.END)
+    symbex.calibrate(CalibrationOp.START, calibrate_probe.PROBE_ID)
+    calibrate_probe.run()
+    symbex.calibrate(CalibrationOp.END, calibrate_probe.PROBE_ID)
+    return True
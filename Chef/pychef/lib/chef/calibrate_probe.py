@@ -0,0 +1,166 @@
+# Generated by Chef/utils/gen_calibration_probe.py from Include/opcode.h.
+# Do not edit.
+
+"""Interpreter calibration probe."""
+
+
+from chef import symbex
+
+
+# Identifies the probe in the calibration cache
+PROBE_ID = "606ae801cdfc4e75"
+
+
+class _Object(object):
+    pass
+
+
+class _Context(object):
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc_info):
+        return False
+
+
+class _NullFile(object):
+    softspace = 0
+
+    def write(self, data):
+        pass
+
+
+def run():
+    global _g
+    x = 6
+    y = 2
+    z = 1
+    k = 0
+    s = [1, 2, 3, 4, 5, 6, 7, 8]
+    u = [0, 1]
+    p = (x, y)
+    d = {x: y}
+    o = _Object()
+    c = _Context()
+    n = _NullFile()
+    symbex.calibrate(1, 0)
+    x += y
+    y += y
+    x *= 2
+    y /= 2
+    symbex.calibrate(1, 5)
+    z = x + y
+    z = x - y
+    z = x * y
+    z = x / y
+    symbex.calibrate(1, 5)
+    z = x // y
+    z = x % y
+    z = x ** y
+    z = x << y
+    symbex.calibrate(1, 5)
+    z = x >> y
+    z = x & y
+    z = x ^ y
+    z = x | y
+    symbex.calibrate(1, 5)
+    z -= y
+    z //= y
+    z %= y
+    z **= y
+    symbex.calibrate(1, 5)
+    z <<= y
+    z >>= y
+    z &= y
+    z ^= y
+    symbex.calibrate(1, 5)
+    z |= y
+    z = +x
+    z = -x
+    z = ~x
+    symbex.calibrate(1, 5)
+    z = `x`
+    z = not x
+    z = x < y
+    z = s[y]
+    symbex.calibrate(1, 5)
+    s[y] = x
+    d[x] = y
+    del d[x]
+    z = s[:]
+    symbex.calibrate(1, 5)
+    z = s[x:]
+    z = s[:y]
+    z = s[y:x]
+    z = s[::y]
+    symbex.calibrate(1, 5)
+    u[:] = s
+    u[x:] = s
+    u[:y] = s
+    u[y:x] = s
+    symbex.calibrate(1, 5)
+    u[y:x] += s
+    del u[x:]
+    del u[:y]
+    del u[y:x]
+    symbex.calibrate(1, 5)
+    del u[:]
+    z = (x, y)
+    z = [x, y]
+    z = {x, y}
+    symbex.calibrate(1, 5)
+    z = {x: y}
+    symbex.calibrate(1, 2)
+    z = [w for w in s]
+    symbex.calibrate(1, 10)
+    z = {w for w in s}
+    symbex.calibrate(1, 11)
+    z = {w: w for w in s}
+    symbex.calibrate(1, 11)
+    z = list(w for w in s)
+    symbex.calibrate(1, 11)
+    w, v = x, y
+    w, v, z = x, y, x
+    w, v = p
+    z = w = x
+    symbex.calibrate(1, 5)
+    del w
+    o.a = x
+    z = o.a
+    del o.a
+    symbex.calibrate(1, 5)
+    x.bit_length()
+    k = x
+    z = k
+    z = lambda: k
+    symbex.calibrate(1, 5)
+    z = lambda: 0
+    _g = x
+    z = _g
+    del _g
+    symbex.calibrate(1, 5)
+    from sys import maxint
+    z = max(*p)
+    z = dict(**d)
+    z = dict(*(), **d)
+    symbex.calibrate(1, 5)
+    print >>n, x
+    symbex.calibrate(1, 4)
+    z = x and y
+    z = x or y
+    z = x if y else y
+    z = y if not x else x
+    symbex.calibrate(1, 5)
+    for w in s: break
+    symbex.calibrate(1, 2)
+    for w in s:
+        try: continue
+        finally: pass
+    symbex.calibrate(1, 26)
+    try: raise ValueError(x)
+    except ValueError: pass
+    symbex.calibrate(1, 3)
+    with c: pass
+    symbex.calibrate(1, 4)
+    class C(object): w = 0; v = w; del w
+    symbex.calibrate(1, 3)
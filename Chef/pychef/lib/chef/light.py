@@ -28,11 +28,17 @@ __author__ = "stefan.bucur@epfl.ch (Stefan Bucur)"
 
 import argparse
 import collections
+import cPickle
 import cStringIO
 import logging
+import multiprocessing
+import os
+import Queue
 import re
+import shutil
 import struct
 import sys
+import tempfile
 import traceback
 
 from chef import symbex
@@ -47,6 +53,12 @@ class ChefSymCall(object):
     END_CONCOLIC_SESSION = 1
     LOG_MESSAGE = 2
     REPORT_PROCESS_MAP = 3
+    TRACE_BATCH = 4
+    TRACE_DELTA = 5
+    CODE_TABLE = 6
+    INSN_BATCH = 7
+    OPCODE_TABLE = 8
+    REPORT_MAPPINGS = 9
 
 
 class SymbolicTest(object):
@@ -67,20 +79,37 @@ class SymbolicTest(object):
             if name not in self.replay_assgn:
                 logging.info("Key '%s' not found in assignment. Using default '%s'." % (name, default))
                 return default
-            return int(self.replay_assgn[name])
+            return self._replay_number(default, self.replay_assgn[name])
         elif not (max_value is None and min_value is None):
             return symbex.symint(default, name, max_value, min_value)
         else:
             return symbex.symint(default, name)
 
-    def getString(self, name, default, max_size=None, min_size=None, ascii=False):
-        if not isinstance(default, basestring):
-            raise ValueError("Default value must be string or unicode")
+    @staticmethod
+    def _replay_number(default, value):
+        """Returns the replayed value of a number.  The values decoded from
+        the test cases already have the type of the symbolic value; the values
+        given on the command line are strings, parsed as the type of the
+        default."""
+        if not isinstance(value, basestring):
+            return value
+        if isinstance(default, bool):
+            return value.strip().lower() in ("1", "true")
+        return type(default)(value)
+
+    def getString(self, name, default, max_size=None, min_size=None, ascii=False,
+                  chars=None):
+        """Returns a symbolic string.  `chars' optionally names the character
+        class of the string, as understood by symbex.assumerange()."""
+        if not isinstance(default, (basestring, bytearray)):
+            raise ValueError("Default value must be string, unicode or bytearray")
 
         if self.replay:
             if name not in self.replay_assgn:
                 logging.info("Key '%s' not found in assignment. Using default '%s'." % (name, default))
                 return default
+            if isinstance(default, bytearray):
+                return bytearray(self.replay_assgn[name])
             return self.replay_assgn[name]
         elif not (max_size is None and min_size is None):
             value = symbex.symsequence(default, name, max_size, min_size)
@@ -88,10 +117,29 @@ class SymbolicTest(object):
             value = symbex.symsequence(default, name)
 
         if ascii:
-            symbex.assumeascii(value)
+            symbex.assumerange(value, "ascii")
+        if chars:
+            symbex.assumerange(value, chars)
 
         return value
 
+    def getMany(self, specs):
+        """Returns a list of symbolic ints and strings, given as tuples of
+        the getInt() and getString() arguments (name, default[, max, min]).
+
+        In symbolic mode, the values are all marked in a single call."""
+        for spec in specs:
+            if not isinstance(spec[1], (int, basestring)):
+                raise ValueError("Default value must be int, string or unicode")
+
+        if self.replay:
+            return [self.getInt(*spec) if isinstance(spec[1], int)
+                    else self.getString(*spec)
+                    for spec in specs]
+
+        return symbex.symbolic_many([(spec[1], spec[0]) + tuple(spec[2:])
+                                     for spec in specs])
+
     def log(self, message):
         if self.replay:
             print "*log* %s" % message
@@ -134,14 +182,20 @@ def runFromArgs(symbolic_test, arg_list=None, **test_args):
                              help="Replay with default concolics")
     replay_mode.add_argument("-f", dest="replay_file",
                              help="Replay from file with test cases")
+    parser.add_argument("--jobs", "-j", type=int, default=1,
+                        help="Number of processes replaying the test cases of -f")
+    parser.add_argument("--fork-server", action="store_true", default=False,
+                        help="Set up the test once and replay each test case "
+                             "in a forked process")
     args = parser.parse_args(args=arg_list)
 
     assignment = {key: value.decode("string-escape") for key, value in (args.assgn or [])}
 
     if args.replay or assignment or args.replay_file:
-        replayer = TestCaseReplayer(symbolic_test, **test_args)
+        replayer = TestCaseReplayer(symbolic_test, jobs=args.jobs,
+                                    fork_server=args.fork_server, **test_args)
         if args.replay_file:
-            with open(args.replay_file, "r") as f:
+            with open(args.replay_file, "rb") as f:
                 test_cases = SymbolicTestCase.from_file(f)
                 replayer.replay(test_cases)
         elif args.replay:
@@ -160,12 +214,10 @@ def runSymbolic(symbolic_test, sym_size=0, **test_args):
     test_inst = symbolic_test(sym_size=sym_size, **test_args)
     test_inst.setUp()
 
-    with open("/proc/self/maps", "r") as f:
-        data = f.read()
-        try:
-            symbex.symcall(CHEF_S2E_PLUGIN, ChefSymCall.REPORT_PROCESS_MAP, data)
-        except symbex.SymbexError:
-            logging.warning("Could not report the procmap. Skipping.")
+    try:
+        symbex.report_process_map()
+    except symbex.SymbexError:
+        logging.warning("Could not report the procmap. Skipping.")
 
     calibrate.perform_calibration()
 
@@ -178,26 +230,138 @@ def runSymbolic(symbolic_test, sym_size=0, **test_args):
         symbex.killstate(0, "Symbolic test ended")
 
 
-# def _read_proto_messages(f):
-#     """Iterates over the protobuf messages in a file."""
-#
-#     header_fmt = "=I"
-#     header_size = struct.calcsize(header_fmt)
-#
-#     while True:
-#         header = f.read(header_size)
-#         if len(header) < header_size:
-#             break
-#         msg_size = struct.unpack(header_fmt, header)[0]
-#         message = f.read(msg_size)
-#         if len(message) < msg_size:
-#             break
-#
-#         yield message
+_PROTO_HEADER_FMT = "=I"
+_PROTO_HEADER_SIZE = struct.calcsize(_PROTO_HEADER_FMT)
+
+_INDEX_ENTRY_FMT = "<Q"
+_INDEX_ENTRY_SIZE = struct.calcsize(_INDEX_ENTRY_FMT)
+
+
+def _read_proto_message(f):
+    """Reads the length-prefixed protobuf message at the current position of
+    the file.  Returns None at the end of the file or on a truncated
+    message (e.g., one still being written)."""
+
+    header = f.read(_PROTO_HEADER_SIZE)
+    if len(header) < _PROTO_HEADER_SIZE:
+        return None
+    msg_size = struct.unpack(_PROTO_HEADER_FMT, header)[0]
+    message = f.read(msg_size)
+    if len(message) < msg_size:
+        return None
+
+    return message
+
+
+def _read_proto_messages(f):
+    """Iterates over the protobuf messages in a file, one at a time."""
+
+    while True:
+        message = _read_proto_message(f)
+        if message is None:
+            break
+        yield message
+
+
+def _scan_proto_offsets(f, offset=0):
+    """Iterates over the offsets of the complete messages in a file,
+    starting with the message at `offset'.  Only the headers are read."""
+
+    f.seek(0, os.SEEK_END)
+    file_size = f.tell()
+
+    while offset + _PROTO_HEADER_SIZE <= file_size:
+        f.seek(offset)
+        msg_size = struct.unpack(_PROTO_HEADER_FMT,
+                                 f.read(_PROTO_HEADER_SIZE))[0]
+        msg_end = offset + _PROTO_HEADER_SIZE + msg_size
+        if msg_end > file_size:
+            break
+        yield offset
+        offset = msg_end
+
+
+def _update_proto_index(f):
+    """Brings up to date the index of the test case file `f' and returns its
+    path, or None if the file cannot be indexed.
+
+    The index is a sidecar "<file>.idx" file holding the offset of each
+    message as a fixed-size entry, so the message count and the last
+    messages are found in constant time.  It is extended incrementally as
+    the test case file grows, and rebuilt if the file no longer matches it.
+    """
+
+    name = getattr(f, "name", None)
+    if not isinstance(name, basestring) or name.startswith("<"):
+        return None
+    index_path = name + ".idx"
+
+    try:
+        index = open(index_path, "r+b" if os.path.exists(index_path) else "w+b")
+    except IOError:
+        logging.warning("Could not open the test case index %s" % index_path)
+        return None
+
+    with index:
+        index.seek(0, os.SEEK_END)
+        index_size = index.tell() - index.tell() % _INDEX_ENTRY_SIZE
+
+        scan_offset, indexed = 0, False
+        if index_size:
+            index.seek(index_size - _INDEX_ENTRY_SIZE)
+            last_offset = struct.unpack(_INDEX_ENTRY_FMT,
+                                        index.read(_INDEX_ENTRY_SIZE))[0]
+            if next(_scan_proto_offsets(f, last_offset), None) == last_offset:
+                scan_offset, indexed = last_offset, True
+            else:
+                logging.info("Rebuilding stale test case index %s" % index_path)
+                index_size = 0
+
+        index.seek(index_size)
+        index.truncate()
+        offsets = _scan_proto_offsets(f, scan_offset)
+        if indexed:
+            next(offsets)  # Already in the index
+        for offset in offsets:
+            index.write(struct.pack(_INDEX_ENTRY_FMT, offset))
+
+    return index_path
+
+
+def _last_proto_messages(f, max_count):
+    """Returns the last `max_count' messages of a file, using its index if
+    possible."""
+
+    index_path = _update_proto_index(f)
+    if index_path is None:
+        offsets = collections.deque(_scan_proto_offsets(f), max_count)
+    else:
+        with open(index_path, "rb") as index:
+            index.seek(0, os.SEEK_END)
+            count = min(max_count, index.tell() / _INDEX_ENTRY_SIZE)
+            index.seek(-count * _INDEX_ENTRY_SIZE, os.SEEK_END)
+            offsets = struct.unpack("<%dQ" % count,
+                                    index.read(count * _INDEX_ENTRY_SIZE))
+
+    messages = []
+    for offset in offsets:
+        f.seek(offset)
+        messages.append(_read_proto_message(f))
+    return messages
+
+
+def _count_proto_messages(f):
+    """Returns the number of messages in a file, using its index if
+    possible."""
+
+    index_path = _update_proto_index(f)
+    if index_path is None:
+        return sum(1 for _ in _scan_proto_offsets(f))
+    return os.path.getsize(index_path) / _INDEX_ENTRY_SIZE
 
 
 class SymbolicTestCase(object):
-    _assignment_name_re = re.compile(r"([^.]*)(?:[.]([is])(?:#(\w+))?)?")  # Values of form: name.k#value
+    _assignment_name_re = re.compile(r"([^.]*)(?:[.]([isuobfL])(?:#(\w+))?)?")  # Values of form: name.k#value
 
     def __init__(self):
         self._proto_msg = None
@@ -214,48 +378,140 @@ class SymbolicTestCase(object):
         """Timestamp in seconds"""
         return float(self._time_stamp) / 1000000
 
+    @staticmethod
+    def _unpack_word(value):
+        """Decodes a C long or Py_ssize_t of the guest."""
+        return struct.unpack("<i" if len(value) == 4 else "<q", value)[0]
+
+    @staticmethod
+    def _unpack_unicode(value):
+        """Decodes a Py_UNICODE buffer of the guest, which has the code unit
+        width of this interpreter."""
+        wide = sys.maxunicode > 0xFFFF
+        units = struct.unpack("<%d%s" % (len(value) / (4 if wide else 2),
+                                         "I" if wide else "H"), value)
+        return u"".join(unichr(u) if u <= sys.maxunicode else u"\ufffd"
+                        for u in units)
+
+    @staticmethod
+    def _unpack_long_digits(part, value):
+        """Decodes the digits of a long, with the part name <sign><bits>."""
+        sign, bits = (-1 if part.startswith("neg") else 1), int(part[3:])
+        digit_size = 2 if bits <= 16 else 4
+        digits = struct.unpack("<%d%s" % (len(value) / digit_size,
+                                          "H" if digit_size == 2 else "I"),
+                               value)
+        return sign * sum(long(d) << (bits * i) for i, d in enumerate(digits))
+
     @classmethod
     def _decode_assignment(cls, name, value):
         match = cls._assignment_name_re.match(name)
         base_name, kind = match.group(1), (match.group(2) or "s")
         if kind == "s":
             return base_name, value
+        elif kind == "u":
+            return base_name, cls._unpack_unicode(value)
         elif kind == "i":
-            return base_name, struct.unpack("<i", value)[0]
+            return base_name, cls._unpack_word(value)
+        elif kind == "o":
+            return base_name, bool(cls._unpack_word(value))
+        elif kind == "b":
+            return base_name, bytearray(value)
+        elif kind == "f":
+            return base_name, struct.unpack("<d", value)[0]
+        elif kind == "L":
+            return base_name, cls._unpack_long_digits(match.group(3), value)
         else:
             raise ValueError("Invalid assignment encoding")
 
-    # @classmethod
-    # def from_protobuf(cls, data):
-    #     message = TestCase_pb2()
-    #     message.ParseFromString(data)
-    #
-    #     test_case = cls()
-    #     test_case._proto_msg = message
-    #
-    #     test_case._time_stamp = message.time_stamp
-    #     test_case.assignment = dict(cls._decode_assignment(assgn.name, assgn.value)
-    #                                 for assgn in message.input.var_assignment)
-    #     test_case.output = message.output
-    #     test_case.high_level_path_id = message.high_level_path_id
-    #     if message.HasField('relevant_path_count'):
-    #         test_case.relevant_path_count = message.relevant_path_count
-    #
-    #     return test_case
-
-    # @classmethod
-    # def from_file(cls, f):
-    #     for message in _read_proto_messages(f):
-    #         yield cls.from_protobuf(message)
-
-    # @classmethod
-    # def last_from_file(cls, f, max_count=1):
-    #     return map(cls.from_protobuf,
-    #                collections.deque(_read_proto_messages(f), max_count))
-
-    # @classmethod
-    # def count_from_file(cls, f):
-    #     return sum(1 for _ in _read_proto_messages(f))
+    @classmethod
+    def _decode_assignments(cls, name, value):
+        """Iterates over the (name, value) pairs of an assignment.
+
+        The batches marked by symbex.symbolic_many() are a single variable
+        named "@batch|<field>:<size>|...", which is split into its fields."""
+        if not name.startswith("@batch|"):
+            yield cls._decode_assignment(name, value)
+            return
+
+        offset = 0
+        last_name, last_value = None, None
+        for field in name.split("|")[1:]:
+            field_name, size = field.rsplit(":", 1)
+            field_value = value[offset:offset + int(size)]
+            offset += int(size)
+
+            base_name, _, kind = field_name.partition(".")
+            if kind.startswith("l") and base_name == last_name:
+                # The size field of the preceding sequence
+                seq_size = cls._unpack_word(field_value)
+                last_value = last_value[:max(seq_size, 0)]
+                continue
+
+            if last_name is not None:
+                yield last_name, last_value
+            last_name, last_value = cls._decode_assignment(field_name, field_value)
+
+        if last_name is not None:
+            yield last_name, last_value
+
+    @classmethod
+    def from_protobuf(cls, data):
+        from chef import TestCase_pb2
+
+        message = TestCase_pb2.TestCase()
+        message.ParseFromString(data)
+
+        test_case = cls()
+        test_case._proto_msg = message
+
+        test_case._time_stamp = message.time_stamp
+        test_case.assignment = dict(pair for assgn in message.input.var_assignment
+                                    for pair in cls._decode_assignments(assgn.name, assgn.value))
+        test_case.output = message.output
+        test_case.high_level_path_id = message.high_level_path_id
+        if message.HasField('relevant_path_count'):
+            test_case.relevant_path_count = message.relevant_path_count
+
+        return test_case
+
+    @classmethod
+    def from_file(cls, f):
+        """Iterates over the test cases of a file, without loading it whole."""
+        for message in _read_proto_messages(f):
+            yield cls.from_protobuf(message)
+
+    @classmethod
+    def last_from_file(cls, f, max_count=1):
+        return map(cls.from_protobuf, _last_proto_messages(f, max_count))
+
+    @classmethod
+    def count_from_file(cls, f):
+        return _count_proto_messages(f)
+
+
+def _get_coverage_data(cov):
+    """Returns the line and arc data of a stopped coverage instance, as
+    {file name: [line]} and {file name: [(from, to)]} dicts."""
+    if hasattr(cov, "get_data"):  # coverage >= 4.0
+        data = cov.get_data()
+        return ({f: list(data.lines(f) or []) for f in data.measured_files()},
+                {f: list(data.arcs(f) or []) for f in data.measured_files()})
+    cov._harvest_data()
+    return cov.data.line_data(), cov.data.arc_data()
+
+
+def _add_coverage_data(cov, cov_data):
+    """Adds line and arc data obtained by _get_coverage_data() to `cov'."""
+    lines, arcs = cov_data
+    if hasattr(cov, "get_data"):
+        data = cov.get_data()
+        data.add_lines(lines)
+        if any(arcs.itervalues()):
+            data.add_arcs(arcs)
+        return
+    cov.data.add_line_data(dict((f, dict.fromkeys(l)) for f, l in lines.iteritems()))
+    cov.data.add_arc_data(dict((f, dict.fromkeys(a)) for f, a in arcs.iteritems()))
 
 
 class TestCaseReplayer(object):
@@ -264,53 +520,265 @@ class TestCaseReplayer(object):
                                   (\d+)\s+    # Missed statements
                                   (\d+)%\s*$  # Total coverage""", re.X)
 
-    def __init__(self, symbolic_test, **test_args):
+    # Number of test cases sent at once to a replay worker
+    shard_chunk_size = 64
+
+    def __init__(self, symbolic_test, jobs=1, fork_server=False, **test_args):
         self.symbolic_test = symbolic_test
         self.test_args = test_args
+        self.jobs = max(jobs, 1)
+        self.fork_server = fork_server
         self.errors = []
+        self._error_keys = {}
+        self._server_inst = None
+        self._server_log_roll = []
+
+        # Each replay process saves its coverage data in its own file of the
+        # data directory, and collect() combines them
+        self._data_dir = tempfile.mkdtemp(prefix="chef-replay-")
+        self._cov = self._start_coverage()
 
+    def _make_coverage(self, **kwargs):
         import coverage
-        self._cov = coverage.coverage(cover_pylib=True, branch=False,
-                                      config_file=None, source=None)
-        self._cov.start()
+        return coverage.coverage(data_file=os.path.join(self._data_dir, ".coverage"),
+                                 cover_pylib=True, branch=False,
+                                 config_file=None, source=None, **kwargs)
+
+    def _start_coverage(self):
+        cov = self._make_coverage(data_suffix=True)
+        cov.start()
+        return cov
+
+    def _add_error(self, key, error):
+        """Records an error, unless one with the same key (the exception type
+        and the stack of its traceback) was already seen."""
+        if key in self._error_keys:
+            return
+        self._error_keys[key] = error
+        self.errors.append(error)
+
+    @staticmethod
+    def _current_error(assignment):
+        """Returns the (key, error) pair of the exception being handled."""
+        exc_type, _, exc_tb = sys.exc_info()
+        return ((exc_type.__name__, tuple(traceback.format_tb(exc_tb))),
+                (exc_type.__name__,
+                 str(assignment),
+                 repr(traceback.format_exc())))
+
+    def _run_test(self, test_inst, assignment):
+        """Runs the test and returns the (key, error) pair of its failure,
+        or None if it succeeded."""
+        try:
+            test_inst.runTest()
+        except:
+            logging.exception("Error detected")
+            return self._current_error(assignment)
+        return None
 
     def replay_assignment(self, assignment):
         logging.info("Replaying %s" % assignment)
 
+        if self.fork_server:
+            return self._fork_replay_assignment(assignment)
+
         test_inst = self.symbolic_test(replay=True, replay_assgn=assignment, **self.test_args)
         test_inst.setUp()
 
-        try:
-            test_inst.runTest()
-        except:
-            logging.exception("Error detected")
-            self.errors.append((sys.exc_info()[0].__name__,
-                                str(assignment),
-                                repr(traceback.format_exc())))
+        error = self._run_test(test_inst, assignment)
+        if error:
+            self._add_error(*error)
 
         return test_inst
 
+    def _fork_replay_assignment(self, assignment):
+        """Replays an assignment in a child forked from a test instance set
+        up once, so every test case starts from the same warmed-up state.
+        The child sends back its output, its error and its coverage data
+        over a pipe.  Returns the set-up test instance, with the log roll
+        of the child."""
+        if self._server_inst is None:
+            self._server_inst = self.symbolic_test(replay=True, replay_assgn={},
+                                                   **self.test_args)
+            self._server_inst.setUp()
+            self._server_log_roll = list(self._server_inst._log_roll)
+        test_inst = self._server_inst
+        # Each child starts from the log roll of the set-up, not from the
+        # output of the previous test case
+        test_inst._log_roll = list(self._server_log_roll)
+
+        # Don't let the child output the buffered data of the parent
+        sys.stdout.flush()
+        sys.stderr.flush()
+
+        read_fd, write_fd = os.pipe()
+        pid = os.fork()
+        if pid == 0:
+            os.close(read_fd)
+            try:
+                self._cov.stop()
+                cov = self._make_coverage()
+                cov.start()
+                test_inst.replay_assgn = assignment
+                error = self._run_test(test_inst, assignment)
+                cov.stop()
+                with os.fdopen(write_fd, "wb") as f:
+                    cPickle.dump((test_inst.log_roll, error, _get_coverage_data(cov)),
+                                 f, cPickle.HIGHEST_PROTOCOL)
+            finally:
+                sys.stdout.flush()
+                sys.stderr.flush()
+                os._exit(0)
+
+        os.close(write_fd)
+        with os.fdopen(read_fd, "rb") as f:
+            try:
+                log_roll, error, cov_data = cPickle.load(f)
+            except EOFError:
+                log_roll, error, cov_data = "", None, None
+        _, status = os.waitpid(pid, 0)
+
+        if cov_data is None:
+            error = (("ReplayCrash", status),
+                     ("ReplayCrash", str(assignment),
+                      "Replay process died with status %d" % status))
+        else:
+            _add_coverage_data(self._cov, cov_data)
+        if error:
+            self._add_error(*error)
+
+        test_inst._log_roll = [log_roll]
+        return test_inst
+
     def replay_test_case(self, test_case):
-        test_inst = self.replay_assignment(test_case.assignment)
+        self._replay_output(test_case.assignment, test_case.output)
+
+    def _replay_output(self, assignment, output):
+        test_inst = self.replay_assignment(assignment)
 
-        if test_inst.log_roll != test_case.output:
+        if test_inst.log_roll != output:
             logging.warning("Mismatched test case output output:")
-            logging.warning("Original: %s" % test_case.output)
+            logging.warning("Original: %s" % output)
             logging.warning("Replayed: %s" % test_inst.log_roll)
 
     def replay(self, test_cases):
-        for test_case in test_cases:
-            self.replay_test_case(test_case)
+        if self.jobs == 1:
+            for test_case in test_cases:
+                self.replay_test_case(test_case)
+        else:
+            self._replay_parallel(test_cases)
+
+    def _replay_worker(self, chunks, results):
+        """Replays the chunks of test cases received from the parent process,
+        under a fresh coverage instance."""
+        self._cov.stop()
+        self._cov = self._start_coverage()
+        self.errors = []
+        self._error_keys = {}
+
+        try:
+            for chunk in iter(chunks.get, None):
+                for assignment, output in chunk:
+                    # An error outside of runTest(), such as in setUp(), must
+                    # not take down the worker and the rest of its chunk
+                    try:
+                        self._replay_output(assignment, output)
+                    except Exception:
+                        logging.exception("Error replaying %s" % assignment)
+                        self._add_error(*self._current_error(assignment))
+        finally:
+            self._cov.stop()
+            self._cov.save()
+            results.put(self._error_keys.items())
+
+    @staticmethod
+    def _put_chunk(chunks, workers, chunk):
+        """Sends a chunk to the workers.  Returns False if they all died,
+        so that the chunk can never be received."""
+        while True:
+            try:
+                chunks.put(chunk, timeout=1)
+                return True
+            except Queue.Full:
+                if not any(worker.is_alive() for worker in workers):
+                    return False
+
+    @staticmethod
+    def _get_result(results, workers):
+        """Receives the errors of a worker, or returns None if all the
+        workers died."""
+        while True:
+            try:
+                return results.get(timeout=1)
+            except Queue.Empty:
+                if not any(worker.is_alive() for worker in workers):
+                    # The last worker may have sent its errors just before
+                    # exiting
+                    try:
+                        return results.get(timeout=1)
+                    except Queue.Empty:
+                        return None
+
+    def _replay_parallel(self, test_cases):
+        """Shards the test cases across `jobs' worker processes.  The test
+        cases are read lazily and sent in chunks, so the workers stay busy
+        without loading all the test cases in memory."""
+        chunks = multiprocessing.Queue(2 * self.jobs)
+        results = multiprocessing.Queue()
+        workers = [multiprocessing.Process(target=self._replay_worker,
+                                           args=(chunks, results))
+                   for _ in range(self.jobs)]
+        for worker in workers:
+            worker.start()
+
+        def iter_chunks():
+            chunk = []
+            for test_case in test_cases:
+                chunk.append((test_case.assignment, test_case.output))
+                if len(chunk) == self.shard_chunk_size:
+                    yield chunk
+                    chunk = []
+            if chunk:
+                yield chunk
+            for _ in workers:
+                yield None
+
+        for chunk in iter_chunks():
+            if not self._put_chunk(chunks, workers, chunk):
+                logging.error("All the replay workers died")
+                # Don't wait at exit for the chunks nobody will receive
+                chunks.cancel_join_thread()
+                break
+
+        for _ in workers:
+            worker_errors = self._get_result(results, workers)
+            if worker_errors is None:
+                break
+            for key, error in worker_errors:
+                self._add_error(key, error)
+        for worker in workers:
+            worker.join()
+            if worker.exitcode != 0:
+                self._add_error(("ReplayWorkerCrash", worker.exitcode),
+                                ("ReplayWorkerCrash", None,
+                                 "Replay worker died with status %d" %
+                                 worker.exitcode))
 
     def collect(self):
         self._cov.stop()
-        
+        self._cov.save()
+
+        # Merge the line and arc data of all the replay processes
+        cov = self._make_coverage()
+        cov.combine()
+        shutil.rmtree(self._data_dir, ignore_errors=True)
+
         result = {}
 
         buff = cStringIO.StringIO()
-        self._cov.report(morfs=None, show_missing=False,
-                         file=buff,
-                         omit=None, include=None)
+        cov.report(morfs=None, show_missing=False,
+                   file=buff,
+                   omit=None, include=None)
 
         for line in buff.getvalue().splitlines():
             print line
@@ -325,7 +793,7 @@ class TestCaseReplayer(object):
 
             # XXX: Not very nice either, but the coverage module is quite
             # cumbersome to use for non-trivial tasks.
-            analysis = self._cov.analysis2(file_name + ".py")
+            analysis = cov.analysis2(file_name + ".py")
 
             result[file_name] = {
                 "executable": analysis[1],
@@ -28,16 +28,39 @@ __author__ = "stefan.bucur@epfl.ch (Stefan Bucur)"
 
 
 import os
+import subprocess
 import sys
 
 
 from distutils.core import setup, Extension
 
 
+PROTO_SOURCE = "src/TestCase.proto"
+PROTO_MODULE = "lib/chef/TestCase_pb2.py"
+
+
+def generate_proto():
+    """Generates the chef.TestCase_pb2 module with protoc, next to the
+    package sources, so that it is also found by "pip install -e"."""
+    if (os.path.exists(PROTO_MODULE) and
+            os.path.getmtime(PROTO_MODULE) >= os.path.getmtime(PROTO_SOURCE)):
+        return
+    try:
+        subprocess.check_call(["protoc", "--proto_path=src",
+                               "--python_out=lib/chef", PROTO_SOURCE])
+    except (OSError, subprocess.CalledProcessError) as e:
+        print >>sys.stderr, "Could not generate %s with protoc: %s" % (
+            PROTO_MODULE, e)
+        exit(1)
+
+
 if "S2E_GUEST" not in os.environ:
     print >>sys.stderr, "You must set the S2E_GUEST environment variable."
     exit(1)
 
+os.chdir(os.path.dirname(os.path.abspath(__file__)))
+generate_proto()
+
 
 setup(name="ChefSymTest",
       version='0.1',
@@ -26,46 +26,315 @@
 #include "symbexutils.h"
 #include "s2e.h"
 
+#include <fcntl.h>
+#include <limits.h>
 #include <stdint.h>
 #include <stdlib.h>
-
-#define DEFAULT_MIN_SEQ_SIZE        0
-#define DEFAULT_MAX_SEQ_SIZE     (-1)
-
-#define DEFAULT_MIN_INT_VALUE   (-128)
-#define DEFAULT_MAX_INT_VALUE     127
+#include <string.h>
+#include <unistd.h>
 
 
 enum {
     S2E_CHEF_CALIBRATE_START = 0x1000,
     S2E_CHEF_CALIBRATE_END = 0x1001,
-    S2E_CHEF_CALIBRATE_CHECKPOINT = 0x1002
+    S2E_CHEF_CALIBRATE_CHECKPOINT = 0x1002,
+    S2E_CHEF_CALIBRATE_LOAD = 0x1003
+};
+
+/* The answer of the host to S2E_CHEF_CALIBRATE_LOAD when it restored the
+ * results of an earlier calibration from its cache */
+#define S2E_CHEF_CALIBRATION_CACHED 1
+
+/* Plugin calls of the interpreter analyzer (see ChefSymCall in light.py) */
+#define CHEF_S2E_PLUGIN "InterpreterAnalyzer"
+
+enum {
+    CHEF_SYMCALL_TRACE_BATCH = 4,
+    CHEF_SYMCALL_TRACE_DELTA = 5,
+    CHEF_SYMCALL_CODE_TABLE = 6,
+    CHEF_SYMCALL_INSN_BATCH = 7,
+    CHEF_SYMCALL_OPCODE_TABLE = 8,
+    CHEF_SYMCALL_REPORT_MAPPINGS = 9
 };
 
+/* The number of trace records buffered before a flush */
+#define HL_TRACE_BUFFER_SIZE 256
+/* The number of code table entries published per plugin call */
+#define HL_CODE_TABLE_CHUNK 64
+/* The number of instruction records buffered per thread before a flush */
+#define HL_INSN_BUFFER_SIZE 1024
+/* The static buffers of the process map report */
+#define PROCESS_MAPS_BUFFER_SIZE (256*1024)
+#define PROCESS_MAP_REPORT_SIZE (64*1024)
+
 
 /*== Globals =================================================================*/
 
 static PyObject *SymbexError;
 
 
+/*== Code table ==============================================================*/
+
+/*
+ * The trace records identify the code objects by their registry ID
+ * (co_symbex_id).  The host learns the ID of a code object, along with its
+ * names and line table, once, before the first record that refers to it.
+ */
+typedef struct {
+    uint32_t code_id;
+    uint32_t first_lineno;
+    uintptr_t code;
+    uint32_t code_size;
+    uintptr_t fn_name;
+    uintptr_t file_name;
+    uintptr_t lnotab;
+    uint32_t lnotab_size;
+} __attribute__((packed)) hl_code_entry_t;
+
+static int code_published = 0;
+static int opcodes_published = 0;
+
+static void publish_codes(void) {
+    hl_code_entry_t entries[HL_CODE_TABLE_CHUNK];
+    int registry_size = _PyCode_SymbexRegistrySize();
+    int count = 0;
+
+    /* The opcode metadata goes along with the first code table update */
+    if (!opcodes_published) {
+        s2e_plugin_call(CHEF_S2E_PLUGIN, CHEF_SYMCALL_OPCODE_TABLE,
+                (void*)_PySymbex_OpcodeTable, sizeof(_PySymbex_OpcodeTable));
+        opcodes_published = 1;
+    }
+
+    for (; code_published < registry_size; ++code_published) {
+        PyCodeObject *code = _PyCode_SymbexLookup(code_published);
+        hl_code_entry_t *entry = &entries[count];
+
+        if (code == NULL)
+            continue;
+
+        entry->code_id = code_published;
+        entry->first_lineno = code->co_firstlineno;
+        entry->code = (uintptr_t)PyString_AS_STRING(code->co_code);
+        entry->code_size = PyString_GET_SIZE(code->co_code);
+        entry->fn_name = (uintptr_t)PyString_AS_STRING(code->co_name);
+        entry->file_name = (uintptr_t)PyString_AS_STRING(code->co_filename);
+        entry->lnotab = (uintptr_t)PyString_AS_STRING(code->co_lnotab);
+        entry->lnotab_size = PyString_GET_SIZE(code->co_lnotab);
+
+        if (++count == HL_CODE_TABLE_CHUNK) {
+            s2e_plugin_call(CHEF_S2E_PLUGIN, CHEF_SYMCALL_CODE_TABLE,
+                    entries, count * sizeof(hl_code_entry_t));
+            count = 0;
+        }
+    }
+
+    if (count > 0) {
+        s2e_plugin_call(CHEF_S2E_PLUGIN, CHEF_SYMCALL_CODE_TABLE,
+                entries, count * sizeof(hl_code_entry_t));
+    }
+}
+
+
+/*== Trace buffer ============================================================*/
+
+/* A frame position, as sent in the trace records and the stack deltas */
+typedef struct {
+    uint32_t code_id;
+    uint32_t last_inst;
+    uint32_t line_no;
+} __attribute__((packed)) hl_code_frame_t;
+
+/*
+ * The trace events are packed in a buffer in guest memory and sent to the
+ * host plugin in batches, instead of one custom instruction per event.  The
+ * buffer is part of the guest state, so each forked execution state flushes
+ * its own events.
+ */
+typedef struct {
+    uint32_t reason;
+    hl_code_frame_t frame;
+} __attribute__((packed)) hl_trace_record_t;
+
+static hl_trace_record_t trace_buffer[HL_TRACE_BUFFER_SIZE];
+static int trace_count = 0;
+
+static void trace_flush(void) {
+    if (trace_count == 0)
+        return;
+
+    s2e_plugin_call(CHEF_S2E_PLUGIN, CHEF_SYMCALL_TRACE_BATCH,
+            trace_buffer, trace_count * sizeof(hl_trace_record_t));
+    trace_count = 0;
+}
+
+
+/*== Shadow stack ============================================================*/
+
+/*
+ * The guest keeps a shadow of the call stack the host knows about, so that a
+ * trace synchronization only sends the frames pushed and popped since the
+ * last one, instead of the whole stack.  While tracing, the CALL and RETURN
+ * events keep the shadow stack up to date.
+ *
+ * Each synchronization carries a generation counter.  The host plugin answers
+ * a delta it cannot apply (e.g., the state was restored from a snapshot taken
+ * at another generation) with a non-zero status, and the guest then falls
+ * back to a full stack snapshot.
+ */
+typedef struct {
+    PyFrameObject *frame;
+    PyCodeObject *code;     /* Guards against recycled frame objects */
+} shadow_entry_t;
+
+typedef struct {
+    uint32_t generation;
+    uint32_t pop_count;
+    uint32_t push_count;
+    /* Followed by push_count frames, outermost first */
+} __attribute__((packed)) hl_stack_delta_t;
+
+static shadow_entry_t *shadow_stack = NULL;
+static int shadow_size = 0;
+static int shadow_capacity = 0;
+static int shadow_valid = 0;
+/* Frames of the shadow stack that returned while the trace was off, which
+ * the host has not popped yet, and calls not seen by the host that are
+ * still running */
+static int shadow_pending_pops = 0;
+static int shadow_untraced_depth = 0;
+static uint32_t trace_generation = 0;
+
+static int shadow_reserve(int size) {
+    shadow_entry_t *entries;
+    int capacity;
+
+    if (size <= shadow_capacity)
+        return 0;
+
+    capacity = shadow_capacity ? shadow_capacity : 64;
+    while (capacity < size)
+        capacity *= 2;
+
+    entries = (shadow_entry_t*)PyMem_Realloc(shadow_stack,
+            capacity * sizeof(shadow_entry_t));
+    if (entries == NULL)
+        return -1;
+
+    shadow_stack = entries;
+    shadow_capacity = capacity;
+    return 0;
+}
+
+static void shadow_push(PyFrameObject *frame) {
+    if (!shadow_valid)
+        return;
+    if (shadow_reserve(shadow_size + 1) < 0) {
+        shadow_valid = 0;
+        return;
+    }
+    shadow_stack[shadow_size].frame = frame;
+    shadow_stack[shadow_size].code = frame->f_code;
+    shadow_size++;
+}
+
+static void shadow_pop(PyFrameObject *frame) {
+    if (!shadow_valid)
+        return;
+    if (shadow_size == 0 || shadow_stack[shadow_size - 1].frame != frame) {
+        /* Out of sync with the interpreter; resync at the next init */
+        shadow_valid = 0;
+        return;
+    }
+    shadow_size--;
+}
+
+static int shadow_find(PyFrameObject *frame) {
+    int i;
+
+    for (i = shadow_size - 1; i >= 0; --i) {
+        if (shadow_stack[i].frame == frame &&
+                shadow_stack[i].code == frame->f_code)
+            return i;
+    }
+    return -1;
+}
+
+
 /*== Trace handler ===========================================================*/
 
+static void fill_code_frame(hl_code_frame_t *chef_frame,
+        PyFrameObject *frame) {
+    chef_frame->code_id = frame->f_code->co_symbex_id;
+    chef_frame->last_inst = frame->f_lasti;
+    chef_frame->line_no = frame->f_lineno;
+}
+
+
+static void fill_hl_frame(hl_frame_t *chef_frame, PyFrameObject *frame) {
+    chef_frame->function = (uintptr_t)PyString_AS_STRING(frame->f_code->co_code);
+    chef_frame->last_inst = frame->f_lasti;
+    chef_frame->line_no = frame->f_lineno;
+
+    chef_frame->fn_name = (uintptr_t)PyString_AS_STRING(frame->f_code->co_name);
+    chef_frame->file_name = (uintptr_t)PyString_AS_STRING(frame->f_code->co_filename);
+}
+
+
 static int trace_func(PyObject *obj, PyFrameObject *frame, int what,
         PyObject *arg) {
-    hl_frame_t chef_frame = {0};
+    hl_trace_record_t *record = &trace_buffer[trace_count++];
+    PyCodeObject *code = frame->f_code;
+
+    if (code->co_symbex_id >= code_published) {
+        publish_codes();
+    }
 
-    chef_frame.function = (uintptr_t)PyString_AS_STRING(frame->f_code->co_code);
-    chef_frame.last_inst = frame->f_lasti;
-    chef_frame.line_no = frame->f_lineno;
+    record->reason = what;
+    record->frame.code_id = code->co_symbex_id;
+    record->frame.last_inst = frame->f_lasti;
 
     // XXX: Properly handle the C calls
     if (what == PyTrace_CALL || what == PyTrace_C_CALL) {
-        chef_frame.line_no = frame->f_code->co_firstlineno;
-        chef_frame.fn_name = (uintptr_t)PyString_AS_STRING(frame->f_code->co_name);
-        chef_frame.file_name = (uintptr_t)PyString_AS_STRING(frame->f_code->co_filename);
+        record->frame.line_no = code->co_firstlineno;
+    } else {
+        record->frame.line_no = frame->f_lineno;
     }
 
-    __chef_hl_trace((hl_trace_reason)(what), &chef_frame, 1);
+    if (what == PyTrace_CALL) {
+        shadow_push(frame);
+    } else if (what == PyTrace_RETURN) {
+        shadow_pop(frame);
+    }
+
+    /* Exceptions redirect the control flow, so the host sees them (and the
+     * events leading to them) right away. */
+    if (trace_count == HL_TRACE_BUFFER_SIZE || what == PyTrace_EXCEPTION ||
+            what == PyTrace_C_EXCEPTION) {
+        trace_flush();
+    }
+    return 0;
+}
+
+
+/*
+ * While the trace is off, this profile function follows the returns of the
+ * frames on the shadow stack, so that the next trace_init() can still send
+ * a delta.  The new calls are only counted, since the host never saw them.
+ * Profile functions only see the calls and the returns.
+ */
+static int shadow_profile_func(PyObject *obj, PyFrameObject *frame, int what,
+        PyObject *arg) {
+    if (what == PyTrace_CALL) {
+        shadow_untraced_depth++;
+    } else if (what == PyTrace_RETURN) {
+        if (shadow_untraced_depth > 0) {
+            shadow_untraced_depth--;
+        } else {
+            shadow_pop(frame);
+            shadow_pending_pops++;
+        }
+    }
     return 0;
 }
 
@@ -77,37 +346,294 @@ static int count_frames(PyFrameObject *head) {
 }
 
 
-static void trace_init(PyFrameObject *frame) {
+static void trace_init_full(PyFrameObject *frame) {
     int frame_count = count_frames(frame);
+    int i;
 
     hl_frame_t *call_stack = (hl_frame_t*)PyMem_Malloc(frame_count*sizeof(hl_frame_t));
     hl_frame_t *chef_frame = call_stack;
 
-    while (frame != NULL) {
-        chef_frame->function = (uintptr_t)PyString_AS_STRING(frame->f_code->co_code);
-        chef_frame->last_inst = frame->f_lasti;
-        chef_frame->line_no = frame->f_lineno;
+    if (call_stack == NULL) {
+        shadow_valid = 0;
+        return;
+    }
+
+    shadow_valid = (shadow_reserve(frame_count) == 0);
+    shadow_size = shadow_valid ? frame_count : 0;
+    shadow_pending_pops = 0;
 
-        chef_frame->fn_name = (uintptr_t)PyString_AS_STRING(frame->f_code->co_name);
-        chef_frame->file_name = (uintptr_t)PyString_AS_STRING(frame->f_code->co_filename);
+    for (i = frame_count - 1; frame != NULL; --i) {
+        fill_hl_frame(chef_frame, frame);
+        if (shadow_valid) {
+            shadow_stack[i].frame = frame;
+            shadow_stack[i].code = frame->f_code;
+        }
 
         frame = frame->f_back;
         chef_frame++;
     }
 
+    trace_generation++;
     __chef_hl_trace(CHEF_TRACE_INIT, call_stack, frame_count);
 
     PyMem_Free(call_stack);
 }
 
 
+/*
+ * Bring the host's view of the call stack in sync with the current one.  Only
+ * the frames above the deepest frame still on the shadow stack are walked,
+ * so the work and the traffic are proportional to the stack change, not to
+ * the stack depth.
+ */
+static void trace_init(PyFrameObject *frame) {
+    PyFrameObject *head;
+    hl_stack_delta_t *delta;
+    hl_code_frame_t *chef_frame;
+    int push_count = 0;
+    int base, i;
+
+    trace_flush();
+
+    if (!shadow_valid) {
+        trace_init_full(frame);
+        return;
+    }
+
+    for (head = frame; head != NULL; head = head->f_back, ++push_count) {
+        if ((base = shadow_find(head)) >= 0)
+            break;
+    }
+    if (head == NULL)
+        base = -1;
+
+    if (push_count == 0 && base == shadow_size - 1 && shadow_pending_pops == 0)
+        return;
+
+    if (shadow_reserve(base + 1 + push_count) < 0) {
+        trace_init_full(frame);
+        return;
+    }
+
+    delta = (hl_stack_delta_t*)PyMem_Malloc(sizeof(hl_stack_delta_t) +
+            push_count * sizeof(hl_code_frame_t));
+    if (delta == NULL) {
+        trace_init_full(frame);
+        return;
+    }
+    delta->generation = trace_generation + 1;
+    delta->pop_count = shadow_size - (base + 1) + shadow_pending_pops;
+    delta->push_count = push_count;
+
+    chef_frame = (hl_code_frame_t*)(delta + 1);
+    shadow_size = base + 1 + push_count;
+    for (i = shadow_size - 1, head = frame; i > base;
+            --i, head = head->f_back) {
+        hl_code_frame_t local_frame;
+
+        fill_code_frame(&local_frame, head);
+        memcpy(&chef_frame[i - base - 1], &local_frame, sizeof(local_frame));
+        shadow_stack[i].frame = head;
+        shadow_stack[i].code = head->f_code;
+    }
+
+    publish_codes();
+    if (s2e_plugin_call(CHEF_S2E_PLUGIN, CHEF_SYMCALL_TRACE_DELTA, delta,
+            sizeof(hl_stack_delta_t) + push_count * sizeof(hl_code_frame_t)) != 0) {
+        /* The host lost track of the stack (e.g., after a state restore) */
+        trace_init_full(frame);
+    } else {
+        trace_generation++;
+        shadow_pending_pops = 0;
+    }
+
+    PyMem_Free(delta);
+}
+
+
+/*== Instruction trace =======================================================*/
+
+/*
+ * The interpreter loop fills the buffer of the current thread with (code ID,
+ * f_lasti, opcode) records, and calls insn_flush() when it is full.
+ */
+typedef struct {
+    _PySymbexInsnBuffer buffer;
+    _PySymbexInsnRecord records[HL_INSN_BUFFER_SIZE];
+} insn_trace_t;
+
+static void insn_flush(_PySymbexInsnBuffer *buffer) {
+    if (buffer->count == 0)
+        return;
+
+    publish_codes();
+    s2e_plugin_call(CHEF_S2E_PLUGIN, CHEF_SYMCALL_INSN_BATCH,
+            buffer->records, buffer->count * sizeof(_PySymbexInsnRecord));
+    buffer->count = 0;
+}
+
+/* The records are allocated with the buffer */
+static void insn_release(_PySymbexInsnBuffer *buffer) {
+    PyMem_Free(buffer);
+}
+
+static int insn_trace_start(PyThreadState *tstate, int opclass_mask) {
+    insn_trace_t *trace;
+
+    if (tstate->symbex_insn_buffer != NULL) {
+        tstate->symbex_insn_buffer->opclass_mask = opclass_mask;
+        return 0;
+    }
+
+    trace = (insn_trace_t*)PyMem_Malloc(sizeof(insn_trace_t));
+    if (trace == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    trace->buffer.records = trace->records;
+    trace->buffer.count = 0;
+    trace->buffer.capacity = HL_INSN_BUFFER_SIZE;
+    trace->buffer.opclass_mask = opclass_mask;
+    trace->buffer.flush = insn_flush;
+    trace->buffer.release = insn_release;
+
+    tstate->symbex_insn_buffer = &trace->buffer;
+    return 0;
+}
+
+static void insn_trace_stop(PyThreadState *tstate) {
+    _PySymbexInsnBuffer *buffer = tstate->symbex_insn_buffer;
+
+    if (buffer == NULL)
+        return;
+
+    tstate->symbex_insn_buffer = NULL;
+    insn_flush(buffer);
+    insn_release(buffer);
+}
+
+
+/*== Process map =============================================================*/
+
+/*
+ * The host needs the code mappings of the interpreter to tell the
+ * interpreter code apart from the rest of the process.  The report covers
+ * only the executable mappings of the interpreter binary, libpython and
+ * the extension modules, and is built in static buffers, so no Python
+ * object is allocated under symbolic execution.
+ */
+typedef struct {
+    uint64_t start;
+    uint64_t end;
+    uint64_t offset;
+    uint32_t name_size;
+    /* Followed by the name_size bytes of the path, without terminator */
+} __attribute__((packed)) hl_mapping_t;
+
+static char maps_buffer[PROCESS_MAPS_BUFFER_SIZE];
+static char map_report[PROCESS_MAP_REPORT_SIZE];
+static char exe_path[PATH_MAX];
+static ssize_t exe_path_size = -1;
+
+static ssize_t read_process_maps(void) {
+    ssize_t size = 0;
+    ssize_t count;
+    int fd;
+
+    fd = open("/proc/self/maps", O_RDONLY);
+    if (fd < 0)
+        return -1;
+
+    do {
+        count = read(fd, maps_buffer + size, sizeof(maps_buffer) - 1 - size);
+        if (count > 0)
+            size += count;
+    } while ((count > 0 || (count < 0 && errno == EINTR)) &&
+            size < (ssize_t)sizeof(maps_buffer) - 1);
+
+    close(fd);
+    if (count < 0)
+        return -1;
+
+    maps_buffer[size] = '\0';
+    return size;
+}
+
+static int is_interpreter_mapping(const char *path, size_t size) {
+    if (size == (size_t)exe_path_size && memcmp(path, exe_path, size) == 0)
+        return 1;
+    if (size > 3 && memcmp(path + size - 3, ".so", 3) == 0)
+        return 1;
+    return strstr(path, "libpython") != NULL;
+}
+
+/* Returns the number of mappings reported, or -1 if the process map could
+ * not be read. */
+static int report_process_map(void) {
+    char *line, *next;
+    size_t report_size = 0;
+    int count = 0;
+
+    if (exe_path_size < 0) {
+        exe_path_size = readlink("/proc/self/exe", exe_path,
+                sizeof(exe_path) - 1);
+    }
+
+    if (read_process_maps() < 0)
+        return -1;
+
+    /* Each line reads "start-end perms offset dev inode path" */
+    for (line = maps_buffer; *line != '\0'; line = next) {
+        hl_mapping_t mapping;
+        char *p, *path;
+        size_t path_size;
+
+        next = strchr(line, '\n');
+        if (next == NULL)
+            break;      /* Truncated by the buffer size */
+        *next++ = '\0';
+
+        mapping.start = strtoull(line, &p, 16);
+        if (*p++ != '-')
+            continue;
+        mapping.end = strtoull(p, &p, 16);
+        if (strlen(p) < 6 || p[3] != 'x')
+            continue;
+        mapping.offset = strtoull(p + 5, &p, 16);
+
+        path = strchr(p, '/');
+        if (path == NULL)
+            continue;
+        path_size = strlen(path);
+        if (!is_interpreter_mapping(path, path_size))
+            continue;
+
+        if (report_size + sizeof(mapping) + path_size > sizeof(map_report))
+            break;
+        mapping.name_size = path_size;
+        memcpy(map_report + report_size, &mapping, sizeof(mapping));
+        memcpy(map_report + report_size + sizeof(mapping), path, path_size);
+        report_size += sizeof(mapping) + path_size;
+        count++;
+    }
+
+    s2e_plugin_call(CHEF_S2E_PLUGIN, CHEF_SYMCALL_REPORT_MAPPINGS,
+            map_report, report_size);
+    return count;
+}
+
+static void dlopen_hook(const char *pathname) {
+    report_process_map();
+}
+
+
 /*== High-level functions ====================================================*/
 
 PyDoc_STRVAR(symbex_symsequence_doc,
 "symsequence(size, name) --> string object\n\
 \n\
 Mark the given sequence or collection as symbolic. Supported object types: \n\
-str, unicode, list, dict, tuple.");
+str, unicode, bytearray, list, dict, tuple.");
 
 static PyObject *
 symbex_symsequence(PyObject *self, PyObject *args) {
@@ -128,9 +654,10 @@ symbex_symsequence(PyObject *self, PyObject *args) {
 /*----------------------------------------------------------------------------*/
 
 PyDoc_STRVAR(symbex_symint_doc,
-"symint() -> int object\n\
+"symint(number, name[, max, min]) -> number object\n\
 \n\
-Mark the given integer object as symbolic. Supported object types: int.");
+Mark the given number as symbolic. Supported object types: int, bool,\n\
+long, float.  The value constraints only apply to int objects.");
 
 static PyObject *
 symbex_symint(PyObject *self, PyObject *args) {
@@ -144,7 +671,30 @@ symbex_symint(PyObject *self, PyObject *args) {
 		return NULL;
 	}
 
-	return Sym_MakeConcolicInt(target, name, max_value, min_value);
+	return Sym_MakeConcolicNumber(target, name, max_value, min_value);
+}
+
+
+/*----------------------------------------------------------------------------*/
+
+PyDoc_STRVAR(symbex_symbolic_many_doc,
+"symbolic_many(specs) -> list\n\
+\n\
+Mark a batch of objects as symbolic at once.  Each spec is a tuple\n\
+(obj, name[, max, min]) with the arguments of symint() for int objects,\n\
+and of symsequence() for str and unicode objects.  All the values share a\n\
+single concolic region and a single assumption.  Returns the list of the\n\
+new objects, in the order of the specs.");
+
+static PyObject *
+symbex_symbolic_many(PyObject *self, PyObject *args) {
+	PyObject *specs;
+
+	if (!PyArg_ParseTuple(args, "O:symbolic_many", &specs)) {
+		return NULL;
+	}
+
+	return Sym_MakeConcolicMany(specs);
 }
 
 
@@ -213,6 +763,7 @@ symbex_killstate(PyObject *self, PyObject *args) {
   if (!PyArg_ParseTuple(args, "is:killstate", &status, &message))
     return NULL;
 
+  trace_flush();
   Sym_KillState(status, message);
 
   Py_RETURN_NONE;
@@ -248,15 +799,74 @@ Assume that the string passed as argument doesn't contain characters beyond 0x7F
 
 static PyObject *
 symbex_assumeascii(PyObject *self, PyObject *args) {
-	PyStringObject *string_obj;
-	Py_ssize_t i;
+	PyObject *string_obj;
+	const SymCharRange *ranges;
+	int count;
 
 	if (!PyArg_ParseTuple(args, "O!:assumeascii", &PyString_Type, &string_obj)) {
 		return NULL;
 	}
 
-	for (i = 0; i < Py_SIZE(string_obj); ++i) {
-		s2e_assume(((unsigned char)string_obj->ob_sval[i]) < 0x80);
+	count = Sym_GetCharClass("ascii", &ranges);
+	if (Sym_AssumeRange(string_obj, ranges, count) < 0) {
+		return NULL;
+	}
+
+	Py_RETURN_NONE;
+}
+
+/*----------------------------------------------------------------------------*/
+
+PyDoc_STRVAR(symbex_assumerange_doc,
+"assumerange(obj, lo, hi) \n\
+assumerange(obj, class) \n\
+\n\
+Assume that all the characters of the str, unicode or bytearray object\n\
+are in the range [lo, hi], or in the named character class: ascii,\n\
+printable, digit, xdigit, alpha, alnum, lower, upper or space.  A single\n\
+assumption is added for the whole object.");
+
+static PyObject *
+symbex_assumerange(PyObject *self, PyObject *args) {
+	PyObject *target;
+	PyObject *lo_obj;
+	PyObject *hi_obj = NULL;
+	SymCharRange range;
+	const SymCharRange *ranges;
+	int count;
+
+	if (!PyArg_ParseTuple(args, "OO|O:assumerange", &target, &lo_obj,
+			&hi_obj)) {
+		return NULL;
+	}
+
+	if (hi_obj == NULL) {
+		if (!PyString_Check(lo_obj)) {
+			PyErr_SetString(PyExc_TypeError,
+					"assumerange() expects a class name or a range");
+			return NULL;
+		}
+		count = Sym_GetCharClass(PyString_AS_STRING(lo_obj), &ranges);
+		if (count < 0) {
+			PyErr_Format(PyExc_ValueError, "Unknown character class '%s'",
+					PyString_AS_STRING(lo_obj));
+			return NULL;
+		}
+	} else {
+		if (!PyArg_ParseTuple(args, "Okk:assumerange", &target, &range.lo,
+				&range.hi)) {
+			return NULL;
+		}
+		if (range.lo > range.hi) {
+			PyErr_SetString(PyExc_ValueError, "Empty character range");
+			return NULL;
+		}
+		ranges = &range;
+		count = 1;
+	}
+
+	if (Sym_AssumeRange(target, ranges, count) < 0) {
+		return NULL;
 	}
 
 	Py_RETURN_NONE;
@@ -291,30 +901,231 @@ symbex_symcall(PyObject *self, PyObject *args) {
 
 /*----------------------------------------------------------------------------*/
 
+PyDoc_STRVAR(symbex_hltrace_doc,
+"hltrace(enable) \n\
+\n\
+Start or stop reporting the high-level execution trace to the host.\n\
+The events are buffered and sent in batches.  While the trace is stopped,\n\
+a profile function follows the calls, unless the program installed its own.");
+
+static PyObject *
+symbex_hltrace(PyObject *self, PyObject *args) {
+    PyObject *enable;
+    PyThreadState *tstate = PyThreadState_GET();
+
+    if (!PyArg_ParseTuple(args, "O:hltrace", &enable)) {
+        return NULL;
+    }
+
+    if (PyObject_IsTrue(enable)) {
+        /* Frames are matched by address, and a new call may reuse the
+         * address of a returned frame, so a shadow stack that was not kept
+         * up to date while the trace was off is dropped. */
+        if (tstate->c_profilefunc == shadow_profile_func)
+            PyEval_SetProfile(NULL, NULL);
+        else if (tstate->c_tracefunc != trace_func)
+            shadow_valid = 0;
+        trace_init(PyEval_GetFrame());
+        PyEval_SetTrace(trace_func, NULL);
+    } else {
+        PyEval_SetTrace(NULL, NULL);
+        trace_flush();
+        /* Leave any profile function of the program in place */
+        if (tstate->c_profilefunc == NULL && shadow_valid) {
+            shadow_untraced_depth = 0;
+            PyEval_SetProfile(shadow_profile_func, NULL);
+        }
+        else if (tstate->c_profilefunc != shadow_profile_func)
+            shadow_valid = 0;
+    }
+
+    Py_RETURN_NONE;
+}
+
+/*----------------------------------------------------------------------------*/
+
+PyDoc_STRVAR(symbex_insntrace_doc,
+"insntrace(enable[, opclasses]) \n\
+\n\
+Start or stop reporting the executed bytecode instructions of the current\n\
+thread to the host, as (code ID, instruction offset, opcode) records.\n\
+The instructions are recorded by the interpreter loop, without a trace\n\
+function.  If given, opclasses is a sequence of OPCLASS_* constants, and\n\
+only the opcodes of these classes are reported.");
+
+static PyObject *
+symbex_insntrace(PyObject *self, PyObject *args) {
+    PyObject *enable;
+    PyObject *opclasses = NULL;
+    int opclass_mask = ~0;
+
+    if (!PyArg_ParseTuple(args, "O|O:insntrace", &enable, &opclasses)) {
+        return NULL;
+    }
+
+    if (opclasses != NULL) {
+        PyObject *seq = PySequence_Fast(opclasses,
+                "opclasses must be a sequence");
+        Py_ssize_t i;
+
+        if (seq == NULL)
+            return NULL;
+
+        opclass_mask = 0;
+        for (i = 0; i < PySequence_Fast_GET_SIZE(seq); ++i) {
+            long opclass = PyInt_AsLong(PySequence_Fast_GET_ITEM(seq, i));
+            if (opclass == -1 && PyErr_Occurred()) {
+                Py_DECREF(seq);
+                return NULL;
+            }
+            if (opclass < 0 || opclass >= _SYMBEX_OPCLASS_COUNT) {
+                Py_DECREF(seq);
+                PyErr_SetString(PyExc_ValueError, "invalid opcode class");
+                return NULL;
+            }
+            opclass_mask |= 1 << opclass;
+        }
+        Py_DECREF(seq);
+    }
+
+    if (PyObject_IsTrue(enable)) {
+        if (insn_trace_start(PyThreadState_GET(), opclass_mask) < 0)
+            return NULL;
+    } else {
+        insn_trace_stop(PyThreadState_GET());
+    }
+
+    Py_RETURN_NONE;
+}
+
+/*----------------------------------------------------------------------------*/
+
+PyDoc_STRVAR(symbex_report_process_map_doc,
+"report_process_map() -> int\n\
+\n\
+Report the executable mappings of the interpreter and of its extension\n\
+modules to the host, and report them again each time a new extension\n\
+module is loaded.  Returns the number of mappings reported.");
+
+static PyObject *
+symbex_report_process_map(PyObject *self, PyObject *args) {
+    int count = report_process_map();
+
+    if (count < 0) {
+        PyErr_SetFromErrnoWithFilename(SymbexError, "/proc/self/maps");
+        return NULL;
+    }
+
+    _PySymbex_DlopenHook = dlopen_hook;
+    return PyInt_FromLong(count);
+}
+
+/*----------------------------------------------------------------------------*/
+
+PyDoc_STRVAR(symbex_allocstats_doc,
+"allocstats() -> (policy, counts)\n\
+\n\
+Return the name of the concretization policy of the symbolic allocation\n\
+sizes, selected by the alloc= option, and a dictionary with the number of\n\
+symbolic sizes handled by each policy in the current path.  The bound\n\
+policy falls back to the buckets for large bounds.");
+
+static PyObject *
+symbex_allocstats(PyObject *self, PyObject *args) {
+    PyObject *counts;
+    PyObject *count;
+    int i;
+
+    counts = PyDict_New();
+    if (counts == NULL)
+        return NULL;
+
+    for (i = 0; i < _SYMBEX_ALLOC_POLICY_COUNT; i++) {
+        count = PyInt_FromSsize_t(_PySymbex_AllocCounts[i]);
+        if (count == NULL ||
+                PyDict_SetItemString(counts, _PySymbex_AllocPolicyNames[i],
+                        count) < 0) {
+            Py_XDECREF(count);
+            Py_DECREF(counts);
+            return NULL;
+        }
+        Py_DECREF(count);
+    }
+
+    return Py_BuildValue("(sN)",
+            _PySymbex_AllocPolicyNames[_PySymbex_AllocPolicy], counts);
+}
+
+/*----------------------------------------------------------------------------*/
+
 PyDoc_STRVAR(symbex_calibrate_doc,
-"calibrate(end) \n\
+"calibrate(op[, arg]) \n\
 \n\
-Run a calibration probe to detect interpreter structure");
+Run a step of the calibration probe that detects the interpreter structure.\n\
+The operations are 0 (start), 1 (checkpoint, arg is the number of lines\n\
+run since the previous checkpoint, the checkpoint line included), 2 (end)\n\
+and 3 (load).  The start, end and load operations take the probe\n\
+ID as argument, and identify the calibration results to the host by the\n\
+probe, the interpreter build and the symbolic optimization flags.  Load\n\
+returns True if the host restored earlier results, so the probe can be\n\
+skipped.");
+
+static int
+make_calibration_key(char *key, size_t size, const char *probe_id) {
+    int length = PyOS_snprintf(key, size, "%s|%s|%#x|%s", Py_GetVersion(),
+            Py_GetPlatform(), _Py_SymbexFlags, probe_id);
+
+    if (length < 0 || (size_t)length >= size) {
+        PyErr_SetString(PyExc_ValueError, "Calibration key too long");
+        return -1;
+    }
+    return length;
+}
 
 static PyObject *
 symbex_calibrate(PyObject *self, PyObject *args) {
     unsigned op;
+    PyObject *arg = NULL;
+    const char *probe_id = "";
     unsigned count = 1;
+    char key[512];
+    int key_size;
+    int result;
 
-    if (!PyArg_ParseTuple(args, "I|I:calibrate", &op, &count)) {
+    if (!PyArg_ParseTuple(args, "I|O:calibrate", &op, &arg)) {
         return NULL;
     }
 
+    if (op == 1) {
+        if (arg != NULL) {
+            count = (unsigned)PyInt_AsUnsignedLongMask(arg);
+            if (PyErr_Occurred())
+                return NULL;
+        }
+        s2e_system_call(S2E_CHEF_CALIBRATE_CHECKPOINT, NULL, count);
+        Py_RETURN_NONE;
+    }
+
+    if (arg != NULL) {
+        probe_id = PyString_AsString(arg);
+        if (probe_id == NULL)
+            return NULL;
+    }
+
+    key_size = make_calibration_key(key, sizeof(key), probe_id);
+    if (key_size < 0)
+        return NULL;
+
     switch (op) {
     case 0:
-        s2e_system_call(S2E_CHEF_CALIBRATE_START, NULL, 0);
-        break;
-    case 1:
-        s2e_system_call(S2E_CHEF_CALIBRATE_CHECKPOINT, NULL, count);
+        s2e_system_call(S2E_CHEF_CALIBRATE_START, key, key_size);
         break;
     case 2:
-        s2e_system_call(S2E_CHEF_CALIBRATE_END, NULL, 0);
+        s2e_system_call(S2E_CHEF_CALIBRATE_END, key, key_size);
         break;
+    case 3:
+        result = s2e_system_call(S2E_CHEF_CALIBRATE_LOAD, key, key_size);
+        return PyBool_FromLong(result == S2E_CHEF_CALIBRATION_CACHED);
     default:
         PyErr_SetString(PyExc_ValueError, "Invalid calibration operation");
         return NULL;
@@ -332,6 +1143,8 @@ PyDoc_STRVAR(module_doc,
 static PyMethodDef SymbexMethods[] = {
 	{ "symsequence", symbex_symsequence, METH_VARARGS, symbex_symsequence_doc },
 	{ "symint", symbex_symint, METH_VARARGS, symbex_symint_doc },
+	{ "symbolic_many", symbex_symbolic_many, METH_VARARGS,
+			symbex_symbolic_many_doc },
 	{ "symtoconcrete", symbex_symtoconcrete, METH_VARARGS,
 			symbex_symtoconcrete_doc },
 	{ "concrete", symbex_concrete, METH_VARARGS, symbex_concrete_doc },
@@ -339,6 +1152,12 @@ static PyMethodDef SymbexMethods[] = {
 	{ "symcall", symbex_symcall, METH_VARARGS, symbex_symcall_doc },
 	{ "assume", symbex_assume, METH_VARARGS, symbex_assume_doc },
 	{ "assumeascii", symbex_assumeascii, METH_VARARGS, symbex_assumeascii_doc },
+	{ "assumerange", symbex_assumerange, METH_VARARGS, symbex_assumerange_doc },
+	{ "hltrace", symbex_hltrace, METH_VARARGS, symbex_hltrace_doc },
+	{ "insntrace", symbex_insntrace, METH_VARARGS, symbex_insntrace_doc },
+	{ "report_process_map", symbex_report_process_map, METH_NOARGS,
+	  symbex_report_process_map_doc },
+	{ "allocstats", symbex_allocstats, METH_NOARGS, symbex_allocstats_doc },
 	{ "calibrate", symbex_calibrate, METH_VARARGS, symbex_calibrate_doc },
 	{ NULL, NULL, 0, NULL } /* Sentinel */
 };
@@ -359,4 +1178,13 @@ initsymbex(void) {
 	}
 	Py_INCREF(SymbexError);
 	PyModule_AddObject(m, "SymbexError", SymbexError);
+
+	PyModule_AddIntConstant(m, "OPCLASS_NONE", _SYMBEX_OPCLASS_NONE);
+	PyModule_AddIntConstant(m, "OPCLASS_TRUTH", _SYMBEX_OPCLASS_TRUTH);
+	PyModule_AddIntConstant(m, "OPCLASS_COMPARE", _SYMBEX_OPCLASS_COMPARE);
+	PyModule_AddIntConstant(m, "OPCLASS_ARITH", _SYMBEX_OPCLASS_ARITH);
+	PyModule_AddIntConstant(m, "OPCLASS_SUBSCR", _SYMBEX_OPCLASS_SUBSCR);
+	PyModule_AddIntConstant(m, "OPCLASS_ITER", _SYMBEX_OPCLASS_ITER);
+	PyModule_AddIntConstant(m, "OPCLASS_LOOKUP", _SYMBEX_OPCLASS_LOOKUP);
+	PyModule_AddIntConstant(m, "OPCLASS_CALL", _SYMBEX_OPCLASS_CALL);
 }
@@ -22,6 +22,8 @@
 
 #include "symbexutils.h"
 
+#include <longintrepr.h>
+
 #include "s2e.h"
 
 
@@ -33,7 +35,8 @@
  * The `name' string has the format: <T>#<name>, where T is a format character
  * identifying the Python type used to reconstruct the value when returned
  * by the symbolic execution engine.  Currently supported values: i (int),
- * s (Regular string), u (Unicode string), b (bytearray), l (Python size).
+ * o (bool), L (long digits), f (float), s (Regular string),
+ * u (Unicode string), b (bytearray), l (Python size).
  * 'b' is the default format if the `name' string doesn't obey the format.
  */
 static void makeConcolicBuffer(void *buf, int size,
@@ -170,6 +173,95 @@ PyObject *Sym_MakeConcolicInt(PyObject *target, const char *name,
 }
 
 
+PyObject *Sym_MakeConcolicNumber(PyObject *target, const char *name,
+        long max_value, long min_value) {
+    if (!s2e_version()) {
+        PyErr_SetString(PyExc_RuntimeError, "Not in symbolic mode");
+        return NULL;
+    }
+
+    if (PyBool_Check(target)) {
+        return Sym_MakeConcolicBool(target, name);
+    } else if (PyInt_Check(target)) {
+        return Sym_MakeConcolicInt(target, name, max_value, min_value);
+    } else if (PyLong_Check(target)) {
+        return Sym_MakeConcolicLong(target, name);
+    } else if (PyFloat_Check(target)) {
+        return Sym_MakeConcolicFloat(target, name);
+    } else {
+        PyErr_SetString(PyExc_TypeError, "Unsupported type");
+        return NULL;
+    }
+}
+
+
+PyObject *Sym_MakeConcolicBool(PyObject *target, const char *name) {
+    assert(PyBool_Check(target));
+
+    long value = (target == Py_True);
+
+    makeConcolicBuffer(&value, sizeof(value), name, "value", 'o');
+    s2e_assume((value == 0) | (value == 1));
+
+    /* Forks on the value, as any use of the bool would */
+    return PyBool_FromLong(value);
+}
+
+
+/*
+ * The digits of the long become concolic, while its sign and number of
+ * digits stay concrete.  The part name records the sign and the digit
+ * width, e.g., "L#neg15", for the test case decoder.
+ */
+PyObject *Sym_MakeConcolicLong(PyObject *target, const char *name) {
+    assert(PyLong_Check(target));
+
+    PyLongObject *long_target = (PyLongObject*)target;
+    Py_ssize_t ndigits = Py_SIZE(long_target) < 0 ?
+            -Py_SIZE(long_target) : Py_SIZE(long_target);
+    char part_name[16];
+    int condition = 1;
+    Py_ssize_t i;
+
+    if (ndigits == 0) {
+        Py_INCREF(target);
+        return target;
+    }
+
+    PyLongObject *result = _PyLong_New(ndigits);
+    if (result == NULL) {
+        return NULL;
+    }
+    memcpy(result->ob_digit, long_target->ob_digit, ndigits * sizeof(digit));
+    Py_SIZE(result) = Py_SIZE(long_target);
+
+    snprintf(part_name, sizeof(part_name), "%s%d",
+            Py_SIZE(long_target) < 0 ? "neg" : "pos", PyLong_SHIFT);
+    makeConcolicBuffer(result->ob_digit, ndigits * sizeof(digit), name,
+            part_name, 'L');
+
+    /* Keep the digits in range and the long normalized */
+    for (i = 0; i < ndigits; ++i) {
+        condition &= (result->ob_digit[i] <= PyLong_MASK);
+    }
+    condition &= (result->ob_digit[ndigits - 1] != 0);
+    s2e_assume(condition);
+
+    return (PyObject *)result;
+}
+
+
+PyObject *Sym_MakeConcolicFloat(PyObject *target, const char *name) {
+    assert(PyFloat_Check(target));
+
+    double value = PyFloat_AS_DOUBLE(target);
+
+    makeConcolicBuffer(&value, sizeof(value), name, "value", 'f');
+
+    return PyFloat_FromDouble(value);
+}
+
+
 PyObject *Sym_MakeConcolicSequence(PyObject *target, const char *name,
         int max_size, int min_size) {
     if (!s2e_version()) {
@@ -189,6 +281,8 @@ PyObject *Sym_MakeConcolicSequence(PyObject *target, const char *name,
         return Sym_MakeConcolicString(target, name, max_size, min_size);
     } else if (PyUnicode_Check(target)) {
         return Sym_MakeConcolicUnicode(target, name, max_size, min_size);
+    } else if (PyByteArray_Check(target)) {
+        return Sym_MakeConcolicByteArray(target, name, max_size, min_size);
     } else if (PyList_Check(target)) {
         return Sym_MakeConcolicList(target, name, max_size, min_size);
     } else if (PyDict_Check(target)) {
@@ -276,6 +370,37 @@ PyObject *Sym_MakeConcolicUnicode(PyObject *target,
 }
 
 
+PyObject *Sym_MakeConcolicByteArray(PyObject *target,
+        const char *name, int max_size, int min_size) {
+    assert(PyByteArray_Check(target));
+
+    Py_ssize_t size = PyByteArray_GET_SIZE(target);
+
+    if (checkObjectSize(size, max_size, min_size) < 0) {
+        PyErr_SetString(PyExc_ValueError, "Incompatible size constraints");
+        return NULL;
+    }
+
+    PyObject *result = PyByteArray_FromStringAndSize(NULL, size);
+    if (result == NULL) {
+        return NULL;
+    }
+    if (size > 0) {
+        PyByteArrayObject *ba_result = (PyByteArrayObject*)result;
+        memcpy(ba_result->ob_bytes, PyByteArray_AS_STRING(target), size);
+        makeConcolicBuffer(ba_result->ob_bytes, size, name, "value", 'b');
+    }
+
+    if (max_size >= 0) {
+        makeConcolicBuffer(&Py_SIZE(result), sizeof(Py_SIZE(result)),
+                name, "size", 'l');
+        constrainObjectSize(Py_SIZE(result), max_size, min_size);
+    }
+
+    return result;
+}
+
+
 PyObject *Sym_MakeConcolicList(PyObject *target,
         const char *name, int max_size, int min_size) {
     assert(PyList_Check(target));
@@ -286,14 +411,38 @@ PyObject *Sym_MakeConcolicList(PyObject *target,
         return NULL;
     }
 
-    if (max_size >= 0) {
-        makeConcolicBuffer(&list_target->ob_size, sizeof(list_target->ob_size),
-                name, "size", 'l');
-        constrainObjectSize(list_target->ob_size, max_size, min_size);
+    if (max_size < 0) {
+        Py_INCREF(target);
+        return target;
     }
 
-    Py_INCREF(target);
-    return target;
+    /*
+     * The items of the list must exist for all the sizes of the symbolic
+     * size, so the new list is allocated to the maximum size.  The items
+     * past the size of the target are None.  The list owns all of them, up
+     * to its allocated size, on every path.
+     */
+    Py_ssize_t size = list_target->ob_size;
+    Py_ssize_t bound = (max_size > size) ? max_size : size;
+    Py_ssize_t i;
+
+    PyListObject *list_result = (PyListObject*)PyList_New(bound);
+    if (list_result == NULL) {
+        return NULL;
+    }
+    for (i = 0; i < bound; ++i) {
+        PyObject *item = (i < size) ? list_target->ob_item[i] : Py_None;
+        Py_INCREF(item);
+        list_result->ob_item[i] = item;
+    }
+
+    list_result->ob_size = size;
+    makeConcolicBuffer(&list_result->ob_size, sizeof(list_result->ob_size),
+            name, "size", 'l');
+    constrainObjectSize(list_result->ob_size, max_size, min_size);
+    s2e_assume(list_result->ob_size <= bound);
+
+    return (PyObject*)list_result;
 }
 
 
@@ -316,12 +465,404 @@ PyObject *Sym_MakeConcolicTuple(PyObject *target,
         const char *name) {
     assert(PyTuple_Check(target));
 
-    PyTupleObject *tup_target = (PyTupleObject*)target;
-    makeConcolicBuffer(&tup_target->ob_size, sizeof(tup_target->ob_size),
+    Py_ssize_t size = PyTuple_GET_SIZE(target);
+    Py_ssize_t i;
+
+    /* The empty tuple is a shared singleton, and has no other size */
+    if (size == 0) {
+        Py_INCREF(target);
+        return target;
+    }
+
+    /*
+     * Tuples are shared, so the symbolic size is made on a copy.  The items
+     * of the copy bound the size, and the copy owns all of them, up to its
+     * recorded capacity, on every path.
+     */
+    PyTupleObject *tup_result = (PyTupleObject*)PyTuple_New(size);
+    if (tup_result == NULL) {
+        return NULL;
+    }
+    for (i = 0; i < size; ++i) {
+        PyObject *item = PyTuple_GET_ITEM(target, i);
+        Py_INCREF(item);
+        tup_result->ob_item[i] = item;
+    }
+
+    makeConcolicBuffer(&tup_result->ob_size, sizeof(tup_result->ob_size),
             name, "size", 'l');
-    s2e_assume(tup_target->ob_size >= 0);
-    s2e_assume(tup_target->ob_size < MAX_SYMBOLIC_SIZE);
+    s2e_assume(tup_result->ob_size >= 0);
+    s2e_assume(tup_result->ob_size <= size);
+    _PySymbex_SetCapacity((PyObject*)tup_result, size);
 
-    Py_INCREF(target);
-    return target;
+    return (PyObject*)tup_result;
+}
+
+
+/*
+ * A field of a batch of concolic values (see Sym_MakeConcolicMany).  Each
+ * field occupies `size' bytes of the batch buffer starting at `offset'; a
+ * sequence with a symbolic size is followed by a Py_ssize_t size field.
+ */
+typedef struct {
+    PyObject *target;
+    const char *name;
+    long max_value;
+    long min_value;
+    int sized;
+    Py_ssize_t length;
+    Py_ssize_t offset;
+    Py_ssize_t size;
+} BatchField;
+
+#define BATCH_NAME_PREFIX "@batch"
+
+/* The separators of the batch name format (see makeBatchName) */
+static int checkBatchFieldName(const char *name) {
+    if (strpbrk(name, ".|:#") != NULL) {
+        PyErr_Format(PyExc_ValueError,
+                "Invalid field name '%s': '.', '|', ':' and '#' are reserved",
+                name);
+        return -1;
+    }
+    return 0;
+}
+
+static int parseBatchField(PyObject *spec, BatchField *field) {
+    int max_size = DEFAULT_MAX_SEQ_SIZE;
+    int min_size = DEFAULT_MIN_SEQ_SIZE;
+
+    field->max_value = DEFAULT_MAX_INT_VALUE;
+    field->min_value = DEFAULT_MIN_INT_VALUE;
+
+    if (!PyTuple_Check(spec)) {
+        PyErr_SetString(PyExc_TypeError,
+                "symbolic_many() specs must be tuples");
+        return -1;
+    }
+    if (PyTuple_GET_SIZE(spec) >= 1 && PyInt_Check(PyTuple_GET_ITEM(spec, 0))) {
+        if (!PyArg_ParseTuple(spec, "Os|ll:symbolic_many", &field->target,
+                &field->name, &field->max_value, &field->min_value))
+            return -1;
+        if (checkBatchFieldName(field->name) < 0)
+            return -1;
+        field->sized = 0;
+        field->length = 1;
+        field->size = sizeof(long);
+
+        if (field->max_value >= field->min_value &&
+                (PyInt_AS_LONG(field->target) < field->min_value ||
+                 PyInt_AS_LONG(field->target) > field->max_value)) {
+            PyErr_SetString(PyExc_ValueError, "Incompatible value constraints");
+            return -1;
+        }
+        return 0;
+    }
+
+    if (!PyArg_ParseTuple(spec, "Os|ii:symbolic_many", &field->target,
+            &field->name, &max_size, &min_size))
+        return -1;
+    if (checkBatchFieldName(field->name) < 0)
+        return -1;
+    if (min_size < 0) {
+        PyErr_SetString(PyExc_ValueError, "Minimum size cannot be negative");
+        return -1;
+    }
+
+    if (PyString_Check(field->target)) {
+        field->length = PyString_GET_SIZE(field->target);
+        field->size = field->length;
+    } else if (PyUnicode_Check(field->target)) {
+        field->length = PyUnicode_GET_SIZE(field->target);
+        field->size = PyUnicode_GET_DATA_SIZE(field->target);
+    } else {
+        PyErr_SetString(PyExc_TypeError, "Unsupported type");
+        return -1;
+    }
+    if (checkObjectSize(field->length, max_size, min_size) < 0) {
+        PyErr_SetString(PyExc_ValueError, "Incompatible size constraints");
+        return -1;
+    }
+    field->sized = (max_size >= 0);
+    field->max_value = max_size;
+    field->min_value = min_size;
+    return 0;
+}
+
+/*
+ * The name of the batch region lists its fields in buffer order, as
+ * "@batch|<name>.<T>#<part>:<size>|...", so that the test case decoder can
+ * split the region value back into the individual assignments.
+ */
+static char *makeBatchName(BatchField *fields, Py_ssize_t count) {
+    size_t name_size = sizeof(BATCH_NAME_PREFIX);
+    Py_ssize_t i;
+    char *name, *p;
+
+    for (i = 0; i < count; ++i) {
+        name_size += strlen(fields[i].name) + 64;
+    }
+    name = (char *)PyMem_Malloc(name_size);
+    if (!name) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    p = name + sprintf(name, "%s", BATCH_NAME_PREFIX);
+    for (i = 0; i < count; ++i) {
+        BatchField *field = &fields[i];
+        char type = PyInt_Check(field->target) ? 'i' :
+                (PyString_Check(field->target) ? 's' : 'u');
+
+        p += sprintf(p, "|%s.%c#value:%ld", field->name, type,
+                (long)field->size);
+        if (field->sized) {
+            p += sprintf(p, "|%s.l#size:%ld", field->name,
+                    (long)sizeof(Py_ssize_t));
+        }
+    }
+    return name;
+}
+
+static PyObject *makeBatchObject(BatchField *field, char *buf) {
+    PyObject *result;
+    Py_ssize_t size;
+    long value;
+
+    if (PyInt_Check(field->target)) {
+        memcpy(&value, buf + field->offset, sizeof(value));
+        return PyInt_FromLong(value);
+    }
+
+    if (PyString_Check(field->target)) {
+        result = PyString_FromStringAndSize(buf + field->offset, field->size);
+    } else {
+        result = PyUnicode_FromUnicode((Py_UNICODE *)(buf + field->offset),
+                field->length);
+    }
+    if (result == NULL || !field->sized)
+        return result;
+
+    memcpy(&size, buf + field->offset + field->size, sizeof(size));
+    if (PyString_Check(result)) {
+        Py_SIZE(result) = size;
+    } else {
+        ((PyUnicodeObject *)result)->length = size;
+    }
+    return result;
+}
+
+/*
+ * The constraints of a field, combined without short-circuiting operators
+ * so that evaluating them doesn't fork.
+ */
+static int batchConstraint(BatchField *field, char *buf) {
+    Py_ssize_t size;
+    long value;
+
+    if (PyInt_Check(field->target)) {
+        if (field->max_value < field->min_value)
+            return 1;
+        memcpy(&value, buf + field->offset, sizeof(value));
+        return (value >= field->min_value) & (value <= field->max_value);
+    }
+
+    if (!field->sized)
+        return 1;
+    memcpy(&size, buf + field->offset + field->size, sizeof(size));
+    if (field->max_value > 0) {
+        return (size >= field->min_value) & (size <= field->max_value);
+    }
+    return (size >= field->min_value);
+}
+
+
+PyObject *Sym_MakeConcolicMany(PyObject *specs) {
+    PyObject *seq, *result = NULL;
+    BatchField *fields = NULL;
+    char *buf = NULL, *batch_name = NULL;
+    Py_ssize_t count, buf_size = 0, i;
+    int constraint = 1;
+
+    if (!s2e_version()) {
+        PyErr_SetString(PyExc_RuntimeError, "Not in symbolic mode");
+        return NULL;
+    }
+
+    seq = PySequence_Fast(specs, "symbolic_many() expects a sequence of specs");
+    if (seq == NULL)
+        return NULL;
+    count = PySequence_Fast_GET_SIZE(seq);
+
+    fields = PyMem_New(BatchField, count);
+    if (count > 0 && fields == NULL) {
+        PyErr_NoMemory();
+        goto out;
+    }
+
+    /* Lay out all the values in a single buffer */
+    for (i = 0; i < count; ++i) {
+        if (parseBatchField(PySequence_Fast_GET_ITEM(seq, i), &fields[i]) < 0)
+            goto out;
+        fields[i].offset = buf_size;
+        buf_size += fields[i].size;
+        if (fields[i].sized)
+            buf_size += sizeof(Py_ssize_t);
+    }
+
+    buf = (char *)PyMem_Malloc(buf_size > 0 ? buf_size : 1);
+    if (!buf) {
+        PyErr_NoMemory();
+        goto out;
+    }
+    for (i = 0; i < count; ++i) {
+        BatchField *field = &fields[i];
+        char *p = buf + field->offset;
+
+        if (PyInt_Check(field->target)) {
+            long value = PyInt_AS_LONG(field->target);
+            memcpy(p, &value, sizeof(value));
+        } else {
+            memcpy(p, PyString_Check(field->target) ?
+                    (void *)PyString_AS_STRING(field->target) :
+                    (void *)PyUnicode_AS_UNICODE(field->target), field->size);
+            if (field->sized)
+                memcpy(p + field->size, &field->length, sizeof(field->length));
+        }
+    }
+
+    batch_name = makeBatchName(fields, count);
+    if (batch_name == NULL)
+        goto out;
+
+    /* A single concolic region and a single assumption for the batch */
+    if (buf_size > 0) {
+        s2e_make_concolic(buf, buf_size, batch_name);
+    }
+    for (i = 0; i < count; ++i) {
+        constraint &= batchConstraint(&fields[i], buf);
+    }
+    s2e_assume(constraint);
+
+    result = PyList_New(count);
+    if (result == NULL)
+        goto out;
+    for (i = 0; i < count; ++i) {
+        PyObject *item = makeBatchObject(&fields[i], buf);
+        if (item == NULL) {
+            Py_CLEAR(result);
+            goto out;
+        }
+        PyList_SET_ITEM(result, i, item);
+    }
+
+out:
+    PyMem_Free(batch_name);
+    PyMem_Free(buf);
+    PyMem_Free(fields);
+    Py_DECREF(seq);
+    return result;
+}
+
+
+/*
+ * Character classes for Sym_AssumeRange, as lists of inclusive ranges.
+ */
+static const SymCharRange range_ascii[] = {{0x00, 0x7f}};
+static const SymCharRange range_printable[] = {{0x09, 0x0d}, {0x20, 0x7e}};
+static const SymCharRange range_digit[] = {{'0', '9'}};
+static const SymCharRange range_xdigit[] = {{'0', '9'}, {'A', 'F'}, {'a', 'f'}};
+static const SymCharRange range_alpha[] = {{'A', 'Z'}, {'a', 'z'}};
+static const SymCharRange range_alnum[] = {{'0', '9'}, {'A', 'Z'}, {'a', 'z'}};
+static const SymCharRange range_lower[] = {{'a', 'z'}};
+static const SymCharRange range_upper[] = {{'A', 'Z'}};
+static const SymCharRange range_space[] = {{0x09, 0x0d}, {' ', ' '}};
+
+#define CHAR_CLASS(name) \
+    { #name, range_##name, sizeof(range_##name) / sizeof(range_##name[0]) }
+
+static const struct {
+    const char *name;
+    const SymCharRange *ranges;
+    int count;
+} char_classes[] = {
+    CHAR_CLASS(ascii),
+    CHAR_CLASS(printable),
+    CHAR_CLASS(digit),
+    CHAR_CLASS(xdigit),
+    CHAR_CLASS(alpha),
+    CHAR_CLASS(alnum),
+    CHAR_CLASS(lower),
+    CHAR_CLASS(upper),
+    CHAR_CLASS(space),
+    { NULL, NULL, 0 }
+};
+
+#undef CHAR_CLASS
+
+
+int Sym_GetCharClass(const char *name, const SymCharRange **ranges) {
+    int i;
+
+    for (i = 0; char_classes[i].name != NULL; ++i) {
+        if (strcmp(char_classes[i].name, name) == 0) {
+            *ranges = char_classes[i].ranges;
+            return char_classes[i].count;
+        }
+    }
+    return -1;
+}
+
+
+/*
+ * Whether `c' falls in one of the ranges.  Each range test is a single
+ * unsigned comparison, and the tests are combined without short-circuiting
+ * operators, so that the result is one expression over `c' instead of a
+ * fork per range.
+ */
+static int charInRanges(unsigned long c, const SymCharRange *ranges,
+        int count) {
+    int result = 0;
+    int i;
+
+    for (i = 0; i < count; ++i) {
+        result |= ((c - ranges[i].lo) <= (ranges[i].hi - ranges[i].lo));
+    }
+    return result;
+}
+
+
+int Sym_AssumeRange(PyObject *target, const SymCharRange *ranges,
+        int count) {
+    int condition = 1;
+    Py_ssize_t i, size;
+
+    if (PyString_Check(target)) {
+        const unsigned char *data =
+                (const unsigned char *)PyString_AS_STRING(target);
+        size = PyString_GET_SIZE(target);
+        for (i = 0; i < size; ++i) {
+            condition &= charInRanges(data[i], ranges, count);
+        }
+    } else if (PyByteArray_Check(target)) {
+        const unsigned char *data =
+                (const unsigned char *)PyByteArray_AS_STRING(target);
+        size = PyByteArray_GET_SIZE(target);
+        for (i = 0; i < size; ++i) {
+            condition &= charInRanges(data[i], ranges, count);
+        }
+    } else if (PyUnicode_Check(target)) {
+        const Py_UNICODE *data = PyUnicode_AS_UNICODE(target);
+        size = PyUnicode_GET_SIZE(target);
+        for (i = 0; i < size; ++i) {
+            condition &= charInRanges(data[i], ranges, count);
+        }
+    } else {
+        PyErr_SetString(PyExc_TypeError, "Unsupported type");
+        return -1;
+    }
+
+    /* A single assumption for the whole buffer */
+    s2e_assume(condition);
+    return 0;
 }
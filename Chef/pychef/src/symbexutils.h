@@ -26,6 +26,13 @@
 /* The maximum size of a symbolic dict or tuple */
 #define MAX_SYMBOLIC_SIZE 64
 
+/* The default constraints of symbolic sequences and ints */
+#define DEFAULT_MIN_SEQ_SIZE        0
+#define DEFAULT_MAX_SEQ_SIZE     (-1)
+
+#define DEFAULT_MIN_INT_VALUE   (-128)
+#define DEFAULT_MAX_INT_VALUE     127
+
 
 #include <Python.h>
 
@@ -51,14 +58,21 @@ PyObject *Sym_MakeSymbolicString(unsigned int size, const char *name);
  */
 void Sym_KillState(int status, const char *message);
 
+PyObject *Sym_MakeConcolicNumber(PyObject *target, const char *name,
+        long max_value, long min_value);
 PyObject *Sym_MakeConcolicInt(PyObject *target, const char *name,
         long max_value, long min_value);
+PyObject *Sym_MakeConcolicBool(PyObject *target, const char *name);
+PyObject *Sym_MakeConcolicLong(PyObject *target, const char *name);
+PyObject *Sym_MakeConcolicFloat(PyObject *target, const char *name);
 PyObject *Sym_MakeConcolicSequence(PyObject *target, const char *name,
         int max_size, int min_size);
 PyObject *Sym_MakeConcolicString(PyObject *target,
         const char *name, int max_size, int min_size);
 PyObject *Sym_MakeConcolicUnicode(PyObject *target,
         const char *name, int max_size, int min_size);
+PyObject *Sym_MakeConcolicByteArray(PyObject *target,
+        const char *name, int max_size, int min_size);
 PyObject *Sym_MakeConcolicList(PyObject *target,
         const char *name, int max_size, int min_size);
 PyObject *Sym_MakeConcolicDict(PyObject *target,
@@ -66,5 +80,34 @@ PyObject *Sym_MakeConcolicDict(PyObject *target,
 PyObject *Sym_MakeConcolicTuple(PyObject *target,
         const char *name);
 
+/*
+ * Mark a batch of int, str and unicode objects as concolic, in a single
+ * concolic region constrained by a single assumption.  `specs' is a
+ * sequence of (obj, name[, max, min]) tuples.  Returns a list with the new
+ * objects.
+ */
+PyObject *Sym_MakeConcolicMany(PyObject *specs);
+
+/* An inclusive range of character codes */
+typedef struct {
+    unsigned long lo;
+    unsigned long hi;
+} SymCharRange;
+
+/*
+ * Look up the character class `name' (ascii, printable, digit, xdigit,
+ * alpha, alnum, lower, upper or space).  Returns the number of ranges
+ * stored in `ranges', or -1 if the class is unknown.
+ */
+int Sym_GetCharClass(const char *name, const SymCharRange **ranges);
+
+/*
+ * Assume that every character of the str, unicode or bytearray object
+ * `target' falls in one of the `count' ranges, with a single assumption
+ * for the whole buffer.  Returns -1 with an exception set if the object
+ * type is not supported.
+ */
+int Sym_AssumeRange(PyObject *target, const SymCharRange *ranges, int count);
+
 
 #endif /* SYMBEXUTILS_H_ */
@@ -0,0 +1,357 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2015 EPFL. All rights reserved.
+
+"""Generate the interpreter calibration probe.
+
+The probe (chef/calibrate_probe.py) executes blocks of statements between
+calibration checkpoints.  Together, the statements exercise every opcode of
+Include/opcode.h that can run in a function body, so that the host sees all
+the opcode handlers of the interpreter loop during calibration.
+
+Each checkpoint reports the number of lines executed since the previous one,
+its own line included, as sys.settrace() counts them.  The generator runs the
+probe to measure the counts, so it must run on the interpreter that the probe
+calibrates.  The straight-line statements, which run a single line in the
+frame of the probe, are grouped in blocks of BLOCK_SIZE; the statements that
+loop, call Python code or raise get a checkpoint of their own.
+"""
+
+__author__ = 'stefan.bucur@epfl.ch (Stefan Bucur)'
+
+
+import argparse
+import hashlib
+import sys
+import types
+
+from gen_opcode_table import parse_opcodes
+
+
+# The straight-line statements between two checkpoints
+BLOCK_SIZE = 4
+
+CHECKPOINT_OP = 1
+
+# The file name of the probe code while it is measured
+PROBE_FILENAME = "<calibration probe>"
+
+# The probe variables.  k is only used through a closure, so it is a cell
+# variable, and _g is declared global.
+SETUP = [
+    "x = 6",
+    "y = 2",
+    "z = 1",
+    "k = 0",
+    "s = [1, 2, 3, 4, 5, 6, 7, 8]",
+    "u = [0, 1]",
+    "p = (x, y)",
+    "d = {x: y}",
+    "o = _Object()",
+    "c = _Context()",
+    "n = _NullFile()",
+]
+
+# (statement, opcodes covered), in execution order.  The opcodes produced
+# by every statement (LOAD_FAST, STORE_FAST, LOAD_CONST, RETURN_VALUE, ...)
+# are listed once.
+STATEMENTS = [
+    # The statements of the original hand-written probe
+    ("x += y", ["LOAD_FAST", "STORE_FAST", "INPLACE_ADD"]),
+    ("y += y", []),
+    ("x *= 2", ["LOAD_CONST", "INPLACE_MULTIPLY"]),
+    ("y /= 2", ["INPLACE_DIVIDE"]),
+
+    ("z = x + y", ["BINARY_ADD"]),
+    ("z = x - y", ["BINARY_SUBTRACT"]),
+    ("z = x * y", ["BINARY_MULTIPLY"]),
+    ("z = x / y", ["BINARY_DIVIDE"]),
+    ("z = x // y", ["BINARY_FLOOR_DIVIDE"]),
+    ("z = x % y", ["BINARY_MODULO"]),
+    ("z = x ** y", ["BINARY_POWER"]),
+    ("z = x << y", ["BINARY_LSHIFT"]),
+    ("z = x >> y", ["BINARY_RSHIFT"]),
+    ("z = x & y", ["BINARY_AND"]),
+    ("z = x ^ y", ["BINARY_XOR"]),
+    ("z = x | y", ["BINARY_OR"]),
+
+    ("z -= y", ["INPLACE_SUBTRACT"]),
+    ("z //= y", ["INPLACE_FLOOR_DIVIDE"]),
+    ("z %= y", ["INPLACE_MODULO"]),
+    ("z **= y", ["INPLACE_POWER"]),
+    ("z <<= y", ["INPLACE_LSHIFT"]),
+    ("z >>= y", ["INPLACE_RSHIFT"]),
+    ("z &= y", ["INPLACE_AND"]),
+    ("z ^= y", ["INPLACE_XOR"]),
+    ("z |= y", ["INPLACE_OR"]),
+
+    ("z = +x", ["UNARY_POSITIVE"]),
+    ("z = -x", ["UNARY_NEGATIVE"]),
+    ("z = ~x", ["UNARY_INVERT"]),
+    ("z = `x`", ["UNARY_CONVERT"]),
+    ("z = not x", ["UNARY_NOT"]),
+    ("z = x < y", ["COMPARE_OP"]),
+
+    ("z = s[y]", ["BINARY_SUBSCR"]),
+    ("s[y] = x", ["STORE_SUBSCR"]),
+    ("d[x] = y", []),
+    ("del d[x]", ["DELETE_SUBSCR"]),
+    ("z = s[:]", ["SLICE+0"]),
+    ("z = s[x:]", ["SLICE+1"]),
+    ("z = s[:y]", ["SLICE+2"]),
+    ("z = s[y:x]", ["SLICE+3"]),
+    ("z = s[::y]", ["BUILD_SLICE"]),
+    ("u[:] = s", ["STORE_SLICE+0"]),
+    ("u[x:] = s", ["STORE_SLICE+1"]),
+    ("u[:y] = s", ["STORE_SLICE+2"]),
+    ("u[y:x] = s", ["STORE_SLICE+3"]),
+    ("u[y:x] += s", ["DUP_TOPX", "ROT_FOUR"]),
+    ("del u[x:]", ["DELETE_SLICE+1"]),
+    ("del u[:y]", ["DELETE_SLICE+2"]),
+    ("del u[y:x]", ["DELETE_SLICE+3"]),
+    ("del u[:]", ["DELETE_SLICE+0"]),
+
+    ("z = (x, y)", ["BUILD_TUPLE"]),
+    ("z = [x, y]", ["BUILD_LIST"]),
+    ("z = {x, y}", ["BUILD_SET"]),
+    ("z = {x: y}", ["BUILD_MAP", "STORE_MAP"]),
+    ("z = [w for w in s]", ["GET_ITER", "FOR_ITER", "LIST_APPEND",
+                            "JUMP_ABSOLUTE"]),
+    ("z = {w for w in s}", ["SET_ADD", "MAKE_FUNCTION", "CALL_FUNCTION",
+                            "RETURN_VALUE"]),
+    ("z = {w: w for w in s}", ["MAP_ADD"]),
+    ("z = list(w for w in s)", ["YIELD_VALUE", "POP_TOP", "LOAD_GLOBAL"]),
+
+    ("w, v = x, y", ["ROT_TWO"]),
+    ("w, v, z = x, y, x", ["ROT_THREE"]),
+    ("w, v = p", ["UNPACK_SEQUENCE"]),
+    ("z = w = x", ["DUP_TOP"]),
+    ("del w", ["DELETE_FAST"]),
+
+    ("o.a = x", ["STORE_ATTR"]),
+    ("z = o.a", ["LOAD_ATTR"]),
+    ("del o.a", ["DELETE_ATTR"]),
+    ("x.bit_length()", []),
+
+    ("k = x", ["STORE_DEREF"]),
+    ("z = k", ["LOAD_DEREF"]),
+    ("z = lambda: k", ["LOAD_CLOSURE", "MAKE_CLOSURE"]),
+    ("z = lambda: 0", []),
+
+    ("_g = x", ["STORE_GLOBAL"]),
+    ("z = _g", []),
+    ("del _g", ["DELETE_GLOBAL"]),
+    ("from sys import maxint", ["IMPORT_NAME", "IMPORT_FROM"]),
+
+    ("z = max(*p)", ["CALL_FUNCTION_VAR"]),
+    ("z = dict(**d)", ["CALL_FUNCTION_KW"]),
+    ("z = dict(*(), **d)", ["CALL_FUNCTION_VAR_KW"]),
+    ("print >>n, x", ["PRINT_ITEM_TO", "PRINT_NEWLINE_TO"]),
+
+    ("z = x and y", ["JUMP_IF_FALSE_OR_POP"]),
+    ("z = x or y", ["JUMP_IF_TRUE_OR_POP"]),
+    ("z = x if y else y", ["POP_JUMP_IF_FALSE", "JUMP_FORWARD"]),
+    ("z = y if not x else x", ["POP_JUMP_IF_TRUE"]),
+
+    ("for w in s: break", ["SETUP_LOOP", "BREAK_LOOP", "POP_BLOCK"]),
+    ("for w in s:\n"
+     "    try: continue\n"
+     "    finally: pass", ["CONTINUE_LOOP", "SETUP_FINALLY",
+                           "END_FINALLY"]),
+    ("try: raise ValueError(x)\n"
+     "except ValueError: pass", ["SETUP_EXCEPT", "RAISE_VARARGS"]),
+    ("with c: pass", ["SETUP_WITH", "WITH_CLEANUP"]),
+
+    ("class C(object): w = 0; v = w; del w", ["BUILD_CLASS", "LOAD_LOCALS",
+                                              "STORE_NAME", "LOAD_NAME",
+                                              "DELETE_NAME"]),
+]
+
+# Opcodes that never run in the body of an optimized function
+UNREACHABLE = {
+    "STOP_CODE": "never emitted",
+    "NOP": "removed by the peephole optimizer",
+    "EXTENDED_ARG": "needs arguments over 65535",
+    "PRINT_EXPR": "interactive mode only",
+    "PRINT_ITEM": "writes to stdout",
+    "PRINT_NEWLINE": "writes to stdout",
+    "IMPORT_STAR": "module level only",
+    "EXEC_STMT": "disables the fast locals of the probe",
+    "BINARY_TRUE_DIVIDE": "needs the division future",
+    "INPLACE_TRUE_DIVIDE": "needs the division future",
+}
+
+HEADER = '''\
+# Generated by Chef/utils/gen_calibration_probe.py from Include/opcode.h.
+# Do not edit.
+
+"""Interpreter calibration probe."""
+
+
+from chef import symbex
+
+
+# Identifies the probe in the calibration cache
+PROBE_ID = "%(probe_id)s"
+
+
+class _Object(object):
+    pass
+
+
+class _Context(object):
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc_info):
+        return False
+
+
+class _NullFile(object):
+    softspace = 0
+
+    def write(self, data):
+        pass
+
+
+def run():
+    global _g
+'''
+
+
+def check_coverage(opcodes):
+    covered = set()
+    for _, names in STATEMENTS:
+        covered.update(names)
+
+    unknown = (covered | set(UNREACHABLE)) - set(opcodes.values())
+    if unknown:
+        raise ValueError("Unknown opcodes: %s" % ", ".join(sorted(unknown)))
+    missing = set(opcodes.values()) - covered - set(UNREACHABLE)
+    if missing:
+        raise ValueError("No probe statement for opcodes: %s" %
+                         ", ".join(sorted(missing)))
+
+
+def indent(statement):
+    return "\n".join("    " + line for line in statement.split("\n"))
+
+
+def render_body(blocks, counts):
+    body = [indent(statement) for statement in SETUP]
+    body.append(indent("symbex.calibrate(%d, 0)" % CHECKPOINT_OP))
+
+    for block, count in zip(blocks, counts):
+        body.extend(indent(statement) for statement in block)
+        body.append(indent("symbex.calibrate(%d, %d)" %
+                           (CHECKPOINT_OP, count)))
+
+    return "\n".join(body) + "\n"
+
+
+def measure(body):
+    """Runs the probe with the given body, and returns a (lines, single)
+    pair for each checkpoint after the first one:  the number of lines
+    executed since the previous checkpoint, its own line included, and
+    whether they all ran once, in the frame of the probe."""
+    checkpoints = []
+    state = {"lines": 0, "single": True}
+
+    def calibrate(op, arg=None):
+        checkpoints.append((state["lines"], state["single"]))
+        state["lines"], state["single"] = 0, True
+
+    def trace(frame, event, arg):
+        if frame.f_code.co_filename != PROBE_FILENAME:
+            return None
+        if event == "line":
+            state["lines"] += 1
+            if frame.f_code.co_name != "run":
+                state["single"] = False
+        return trace
+
+    symbex = types.ModuleType("chef.symbex")
+    symbex.calibrate = calibrate
+    chef = types.ModuleType("chef")
+    chef.symbex = symbex
+
+    source = HEADER % {"probe_id": ""} + body
+    namespace = {"__name__": "calibrate_probe"}
+    saved = dict((name, sys.modules.get(name))
+                 for name in ("chef", "chef.symbex"))
+    sys.modules.update({"chef": chef, "chef.symbex": symbex})
+    try:
+        exec compile(source, PROBE_FILENAME, "exec") in namespace
+        sys.settrace(trace)
+        try:
+            namespace["run"]()
+        finally:
+            sys.settrace(None)
+    finally:
+        for name, module in saved.items():
+            if module is None:
+                del sys.modules[name]
+            else:
+                sys.modules[name] = module
+
+    return checkpoints[1:]
+
+
+def layout_blocks():
+    """Groups the statements in blocks, in execution order."""
+    statements = [statement for statement, _ in STATEMENTS]
+    measured = measure(render_body([[statement] for statement in statements],
+                                   [0] * len(statements)))
+
+    blocks, straight = [], []
+    for statement, (lines, single) in zip(statements, measured):
+        if single and lines == 2:
+            straight.append(statement)
+            if len(straight) == BLOCK_SIZE:
+                blocks.append(straight)
+                straight = []
+            continue
+        if straight:
+            blocks.append(straight)
+            straight = []
+        blocks.append([statement])
+    if straight:
+        blocks.append(straight)
+    return blocks
+
+
+def generate():
+    blocks = layout_blocks()
+    counts = [lines for lines, _ in measure(render_body(blocks,
+                                                        [0] * len(blocks)))]
+
+    body = render_body(blocks, counts)
+    probe_id = hashlib.sha1(body.encode("utf-8")).hexdigest()[:16]
+
+    return HEADER % {"probe_id": probe_id} + body
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("infile", nargs='?', type=argparse.FileType('r'),
+                        default=sys.stdin,
+                        help="Include/opcode.h")
+    parser.add_argument("-o", "--output",
+                        help="The generated probe (default: stdout)")
+
+    args = parser.parse_args()
+
+    opcodes, _ = parse_opcodes(args.infile)
+    check_coverage(opcodes)
+    probe = generate()
+
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write(probe)
+    else:
+        sys.stdout.write(probe)
+
+
+if __name__ == "__main__":
+    main()
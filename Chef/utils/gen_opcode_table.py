@@ -3,7 +3,12 @@
 #
 # Copyright 2014 EPFL. All rights reserved.
 
-"""Parse Python's opcode definition table."""
+"""Generate the opcode metadata table of the instrumented interpreter.
+
+The opcode numbers come from Include/opcode.h, the metadata from the OPCODES
+table below.  The output defines _PySymbex_OpcodeTable, compiled into
+Python/ceval.c (see _PySymbexOpcodeInfo in Include/symbex.h).
+"""
 
 __author__ = 'stefan.bucur@epfl.ch (Stefan Bucur)'
 
@@ -13,32 +18,256 @@ import re
 import sys
 
 
-NUM_COLUMNS = 3
+# Opcode flags (the _SYMBEX_OP_* constants)
+BRANCH = "BRANCH"       # May continue elsewhere than the next instruction
+COND = "COND"           # The branch depends on an operand value
+CALLOUT = "CALLOUT"     # May run arbitrary Python or C code
+VAREFFECT = "VAREFFECT" # The stack effect depends on oparg or the outcome
 
+# Symbolic branching classes (the _SYMBEX_OPCLASS_* constants)
+NONE = "NONE"           # Stack, local and block handling
+TRUTH = "TRUTH"         # Branches on the truth value of an operand
+COMPARE = "COMPARE"     # Rich comparisons, including "in" and "is"
+ARITH = "ARITH"         # Numeric and bitwise operators
+SUBSCR = "SUBSCR"       # Indexing and slicing, bounds checks
+ITER = "ITER"           # Depends on the length of a sequence
+LOOKUP = "LOOKUP"       # Name and attribute lookups, hashing and dicts
+CALL = "CALL"           # Calls into functions and classes
 
-def main():
-    parser = argparse.ArgumentParser()
-    parser.add_argument("infile", nargs='?', type=argparse.FileType('r'),
-                        default=sys.stdin)
+# name: (stack effect, flags, class).  The stack effects follow
+# opcode_stack_effect() in Python/compile.c; an effect that depends on the
+# argument is an expression of oparg, and the table stores its value for
+# oparg 0.
+OPCODES = {
+    "STOP_CODE":            (0, [], NONE),
+    "POP_TOP":              (-1, [], NONE),
+    "ROT_TWO":              (0, [], NONE),
+    "ROT_THREE":            (0, [], NONE),
+    "DUP_TOP":              (1, [], NONE),
+    "ROT_FOUR":             (0, [], NONE),
+    "NOP":                  (0, [], NONE),
 
-    args = parser.parse_args()
+    "UNARY_POSITIVE":       (0, [CALLOUT], ARITH),
+    "UNARY_NEGATIVE":       (0, [CALLOUT], ARITH),
+    "UNARY_NOT":            (0, [CALLOUT], TRUTH),
+    "UNARY_CONVERT":        (0, [CALLOUT], NONE),
+    "UNARY_INVERT":         (0, [CALLOUT], ARITH),
+
+    "BINARY_POWER":         (-1, [CALLOUT], ARITH),
+    "BINARY_MULTIPLY":      (-1, [CALLOUT], ARITH),
+    "BINARY_DIVIDE":        (-1, [CALLOUT], ARITH),
+    "BINARY_MODULO":        (-1, [CALLOUT], ARITH),
+    "BINARY_ADD":           (-1, [CALLOUT], ARITH),
+    "BINARY_SUBTRACT":      (-1, [CALLOUT], ARITH),
+    "BINARY_SUBSCR":        (-1, [CALLOUT], SUBSCR),
+    "BINARY_FLOOR_DIVIDE":  (-1, [CALLOUT], ARITH),
+    "BINARY_TRUE_DIVIDE":   (-1, [CALLOUT], ARITH),
+    "INPLACE_FLOOR_DIVIDE": (-1, [CALLOUT], ARITH),
+    "INPLACE_TRUE_DIVIDE":  (-1, [CALLOUT], ARITH),
+
+    "SLICE+0":              (0, [CALLOUT], SUBSCR),
+    "SLICE+1":              (-1, [CALLOUT], SUBSCR),
+    "SLICE+2":              (-1, [CALLOUT], SUBSCR),
+    "SLICE+3":              (-2, [CALLOUT], SUBSCR),
+    "STORE_SLICE+0":        (-2, [CALLOUT], SUBSCR),
+    "STORE_SLICE+1":        (-3, [CALLOUT], SUBSCR),
+    "STORE_SLICE+2":        (-3, [CALLOUT], SUBSCR),
+    "STORE_SLICE+3":        (-4, [CALLOUT], SUBSCR),
+    "DELETE_SLICE+0":       (-1, [CALLOUT], SUBSCR),
+    "DELETE_SLICE+1":       (-2, [CALLOUT], SUBSCR),
+    "DELETE_SLICE+2":       (-2, [CALLOUT], SUBSCR),
+    "DELETE_SLICE+3":       (-3, [CALLOUT], SUBSCR),
+
+    "STORE_MAP":            (-2, [CALLOUT], LOOKUP),
+    "INPLACE_ADD":          (-1, [CALLOUT], ARITH),
+    "INPLACE_SUBTRACT":     (-1, [CALLOUT], ARITH),
+    "INPLACE_MULTIPLY":     (-1, [CALLOUT], ARITH),
+    "INPLACE_DIVIDE":       (-1, [CALLOUT], ARITH),
+    "INPLACE_MODULO":       (-1, [CALLOUT], ARITH),
+    "STORE_SUBSCR":         (-3, [CALLOUT], SUBSCR),
+    "DELETE_SUBSCR":        (-2, [CALLOUT], SUBSCR),
+    "BINARY_LSHIFT":        (-1, [CALLOUT], ARITH),
+    "BINARY_RSHIFT":        (-1, [CALLOUT], ARITH),
+    "BINARY_AND":           (-1, [CALLOUT], ARITH),
+    "BINARY_XOR":           (-1, [CALLOUT], ARITH),
+    "BINARY_OR":            (-1, [CALLOUT], ARITH),
+    "INPLACE_POWER":        (-1, [CALLOUT], ARITH),
+    "GET_ITER":             (0, [CALLOUT], NONE),
+
+    "PRINT_EXPR":           (-1, [CALLOUT], NONE),
+    "PRINT_ITEM":           (-1, [CALLOUT], NONE),
+    "PRINT_NEWLINE":        (0, [CALLOUT], NONE),
+    "PRINT_ITEM_TO":        (-2, [CALLOUT], NONE),
+    "PRINT_NEWLINE_TO":     (-1, [CALLOUT], NONE),
+    "INPLACE_LSHIFT":       (-1, [CALLOUT], ARITH),
+    "INPLACE_RSHIFT":       (-1, [CALLOUT], ARITH),
+    "INPLACE_AND":          (-1, [CALLOUT], ARITH),
+    "INPLACE_XOR":          (-1, [CALLOUT], ARITH),
+    "INPLACE_OR":           (-1, [CALLOUT], ARITH),
+    "BREAK_LOOP":           (0, [BRANCH], NONE),
+    "WITH_CLEANUP":         (-1, [CALLOUT, VAREFFECT], CALL),
+    "LOAD_LOCALS":          (1, [], NONE),
+    "RETURN_VALUE":         (-1, [BRANCH], NONE),
+    "IMPORT_STAR":          (-1, [CALLOUT], LOOKUP),
+    "EXEC_STMT":            (-3, [CALLOUT], CALL),
+    "YIELD_VALUE":          (0, [BRANCH], NONE),
+    "POP_BLOCK":            (0, [], NONE),
+    "END_FINALLY":          (-3, [BRANCH, COND, VAREFFECT], NONE),
+    "BUILD_CLASS":          (-2, [CALLOUT], CALL),
+
+    "STORE_NAME":           (-1, [CALLOUT], LOOKUP),
+    "DELETE_NAME":          (0, [CALLOUT], LOOKUP),
+    "UNPACK_SEQUENCE":      ("oparg-1", [CALLOUT], ITER),
+    "FOR_ITER":             (1, [BRANCH, COND, CALLOUT, VAREFFECT], ITER),
+    "LIST_APPEND":          (-1, [], NONE),
+    "STORE_ATTR":           (-2, [CALLOUT], LOOKUP),
+    "DELETE_ATTR":          (-1, [CALLOUT], LOOKUP),
+    "STORE_GLOBAL":         (-1, [CALLOUT], LOOKUP),
+    "DELETE_GLOBAL":        (0, [CALLOUT], LOOKUP),
+    "DUP_TOPX":             ("oparg", [], NONE),
+    "LOAD_CONST":           (1, [], NONE),
+    "LOAD_NAME":            (1, [CALLOUT], LOOKUP),
+    "BUILD_TUPLE":          ("1-oparg", [], NONE),
+    "BUILD_LIST":           ("1-oparg", [], NONE),
+    "BUILD_SET":            ("1-oparg", [CALLOUT], LOOKUP),
+    "BUILD_MAP":            (1, [], NONE),
+    "LOAD_ATTR":            (0, [CALLOUT], LOOKUP),
+    "COMPARE_OP":           (-1, [CALLOUT], COMPARE),
+    "IMPORT_NAME":          (-1, [CALLOUT], CALL),
+    "IMPORT_FROM":          (1, [CALLOUT], LOOKUP),
+
+    "JUMP_FORWARD":         (0, [BRANCH], NONE),
+    "JUMP_IF_FALSE_OR_POP": (0, [BRANCH, COND, CALLOUT, VAREFFECT], TRUTH),
+    "JUMP_IF_TRUE_OR_POP":  (0, [BRANCH, COND, CALLOUT, VAREFFECT], TRUTH),
+    "JUMP_ABSOLUTE":        (0, [BRANCH], NONE),
+    "POP_JUMP_IF_FALSE":    (-1, [BRANCH, COND, CALLOUT], TRUTH),
+    "POP_JUMP_IF_TRUE":     (-1, [BRANCH, COND, CALLOUT], TRUTH),
+    "LOAD_GLOBAL":          (1, [CALLOUT], LOOKUP),
+
+    "CONTINUE_LOOP":        (0, [BRANCH], NONE),
+    "SETUP_LOOP":           (0, [], NONE),
+    "SETUP_EXCEPT":         (0, [], NONE),
+    "SETUP_FINALLY":        (0, [], NONE),
+
+    "LOAD_FAST":            (1, [], NONE),
+    "STORE_FAST":           (-1, [], NONE),
+    "DELETE_FAST":          (0, [], NONE),
+
+    "RAISE_VARARGS":        ("-oparg", [BRANCH, CALLOUT], NONE),
+    "CALL_FUNCTION":        ("-NARGS(oparg)", [CALLOUT], CALL),
+    "MAKE_FUNCTION":        ("-oparg", [], NONE),
+    "BUILD_SLICE":          ("-1 if oparg != 3 else -2", [], NONE),
+    "MAKE_CLOSURE":         ("-oparg-1", [], NONE),
+    "LOAD_CLOSURE":         (1, [], NONE),
+    "LOAD_DEREF":           (1, [], NONE),
+    "STORE_DEREF":          (-1, [], NONE),
+    "CALL_FUNCTION_VAR":    ("-NARGS(oparg)-1", [CALLOUT], CALL),
+    "CALL_FUNCTION_KW":     ("-NARGS(oparg)-1", [CALLOUT], CALL),
+    "CALL_FUNCTION_VAR_KW": ("-NARGS(oparg)-2", [CALLOUT], CALL),
+    "SETUP_WITH":           (4, [CALLOUT], CALL),
+    "EXTENDED_ARG":         (0, [], NONE),
+    "SET_ADD":              (-1, [CALLOUT], LOOKUP),
+    "MAP_ADD":              (-2, [CALLOUT], LOOKUP),
+}
+
+NUM_OPCODES = 256
+
+
+def NARGS(oparg):
+    return (oparg % 256) + 2 * (oparg // 256)
 
-    define_re = re.compile(r'#define\s+([A-Z_]+)\s*(\d+)')
+
+def parse_opcodes(infile):
+    """Return the opcode names of Include/opcode.h by number, and the value
+    of HAVE_ARGUMENT."""
+
+    define_re = re.compile(r'#define\s+([A-Z_]+)\s+(\d+)')
+    also_re = re.compile(r'/\*\s*Also uses (\d+)-(\d+)\s*\*/')
 
     opcodes = {}
+    have_argument = None
+    last = None
 
-    for line in args.infile:
+    for line in infile:
         match = define_re.match(line)
         if match:
-            opcodes[int(match.group(2))] = match.group(1)
+            name, value = match.group(1), int(match.group(2))
+            if name == "HAVE_ARGUMENT":
+                have_argument = value
+                continue
+            opcodes[value] = name
+            last = (name, value)
+            continue
+        match = also_re.match(line.strip())
+        if match and last:
+            name, value = last
+            opcodes[value] = "%s+0" % name
+            for i in range(int(match.group(1)), int(match.group(2)) + 1):
+                opcodes[i] = "%s+%d" % (name, i - value)
+
+    if have_argument is None:
+        raise ValueError("HAVE_ARGUMENT not found")
+    return opcodes, have_argument
+
+
+def format_entry(name, have_argument, number):
+    effect, flags, opclass = OPCODES[name]
+    flags = ["DEFINED"] + flags
+    if number >= have_argument:
+        flags.append("HASARG")
+    if not isinstance(effect, int):
+        effect = eval(effect, {"NARGS": NARGS}, {"oparg": 0})
+        if VAREFFECT not in flags:
+            flags.append(VAREFFECT)
+
+    return "    {%d, %s, _SYMBEX_OPCLASS_%s}," % (
+        effect, " | ".join("_SYMBEX_OP_%s" % flag for flag in flags), opclass)
+
+
+def generate(opcodes, have_argument):
+    missing = set(opcodes.values()) - set(OPCODES)
+    if missing:
+        raise ValueError("No metadata for opcodes: %s" %
+                         ", ".join(sorted(missing)))
+    stale = set(OPCODES) - set(opcodes.values())
+    if stale:
+        raise ValueError("Metadata for unknown opcodes: %s" %
+                         ", ".join(sorted(stale)))
+
+    lines = [
+        "/* Generated by Chef/utils/gen_opcode_table.py from Include/opcode.h.",
+        "   Do not edit. */",
+        "",
+        "const _PySymbexOpcodeInfo _PySymbex_OpcodeTable[%d] = {" % NUM_OPCODES,
+    ]
+    for i in range(NUM_OPCODES):
+        if i in opcodes:
+            lines.append("%s /* %s */" % (
+                format_entry(opcodes[i], have_argument, i), opcodes[i]))
+        else:
+            lines.append("    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */")
+    lines.append("};")
+    return "\n".join(lines) + "\n"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("infile", nargs='?', type=argparse.FileType('r'),
+                        default=sys.stdin,
+                        help="Include/opcode.h")
+    parser.add_argument("-o", "--output",
+                        help="The generated header (default: stdout)")
+
+    args = parser.parse_args()
 
-    max_opcode = max(opcodes.keys())
+    opcodes, have_argument = parse_opcodes(args.infile)
+    table = generate(opcodes, have_argument)
 
-    print "{"
-    for i in range(max_opcode+1):
-        print "    {%s}, // %s" % (", ".join(["0"] * NUM_COLUMNS),
-                                   opcodes.get(i, "unused"))
-    print "}"
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write(table)
+    else:
+        sys.stdout.write(table)
 
 
 if __name__ == "__main__":
@@ -27,6 +27,10 @@ typedef struct {
 				   Objects/lnotab_notes.txt for details. */
     void *co_zombieframe;     /* for optimization only (see frameobject.c) */
     PyObject *co_weakreflist;   /* to support weakrefs to code objects */
+#ifdef SYMBEX_INSTRUMENTATION
+    int co_symbex_id;		/* stable ID in the code registry, used by the
+				   high-level tracer instead of pointers */
+#endif
 } PyCodeObject;
 
 /* Masks for co_flags above */
@@ -101,6 +105,16 @@ PyAPI_FUNC(int) _PyCode_CheckLineNumber(PyCodeObject* co,
 PyAPI_FUNC(PyObject*) PyCode_Optimize(PyObject *code, PyObject* consts,
                                       PyObject *names, PyObject *lineno_obj);
 
+#ifdef SYMBEX_INSTRUMENTATION
+/* Registry of the code objects, indexed by co_symbex_id.  IDs are assigned
+   in creation order and never reused; the entries of deallocated code
+   objects are NULL.  The tracer publishes the entries past the last one it
+   reported, so the host reads the names and line tables once per code
+   object. */
+PyAPI_FUNC(int) _PyCode_SymbexRegistrySize(void);
+PyAPI_FUNC(PyCodeObject *) _PyCode_SymbexLookup(int id);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -88,6 +88,9 @@ struct _dictobject {
     PyDictEntry *(*ma_lookup)(PyDictObject *mp, PyObject *key, long hash);
     PyDictEntry ma_smalltable[PyDict_MINSIZE];
 #ifdef _SYMBEX_DICT_HASHES
+    /* Non-zero once a symbolic hash has been seen.  The table is then kept
+     * packed in insertion order and searched linearly (see lookdict_flat()).
+     */
     int ma_flat;
 #endif
 };
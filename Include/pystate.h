@@ -95,6 +95,11 @@ typedef struct _ts {
     PyObject *async_exc; /* Asynchronous exception to raise */
     long thread_id; /* Thread id where this tstate was created */
 
+#ifdef SYMBEX_INSTRUMENTATION
+    /* Instruction trace buffer, see _SYMBEX_INSN_TRACE in symbex.h */
+    struct _PySymbexInsnBuffer *symbex_insn_buffer;
+#endif
+
     /* XXX signal handlers should also be here */
 
 } PyThreadState;
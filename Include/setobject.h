@@ -54,6 +54,13 @@ struct _setobject {
 
     long hash;                  /* only used by frozenset objects */
     PyObject *weakreflist;      /* List of weak references */
+#ifdef _SYMBEX_DICT_HASHES
+    /* Non-zero once a symbolic hash has been seen.  The table is then kept
+     * packed in insertion order and searched linearly (see
+     * set_lookkey_flat()).
+     */
+    int flat;
+#endif
 };
 
 PyAPI_DATA(PyTypeObject) PySet_Type;
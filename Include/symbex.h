@@ -2,6 +2,45 @@
 #define SYMBEX_H_
 
 #include "pyconfig.h"
+#include "pyport.h"
+
+/* Runtime symbolic execution options (Python/symbex.c).  A single
+ * instrumented interpreter covers all the optimization levels; the
+ * SYMBEX_OPT_* configure options only select the defaults.
+ */
+
+/* Concretize memory block sizes at allocation */
+#define _SYMBEX_RT_CONCRBUFF      0x01
+/* Do not share one-character strings and the empty string with symbolic
+ * values; concrete values still use the caches.  Small ints with symbolic
+ * values are never shared. */
+#define _SYMBEX_RT_NOINTERN       0x02
+/* Neutral hash for every str and unicode object */
+#define _SYMBEX_RT_CONST_HASHES   0x04
+/* Neutral hash only for strings with symbolic contents or size; concrete
+ * strings get their real hash.  A symbolic string then hashes differently
+ * than an equal concrete one, and so do the tuples and frozensets built
+ * from it, which get the neutral hash too.  Dicts and sets switch to flat
+ * mode when they see a neutral hash, and flat lookups never filter entries
+ * on it.
+ */
+#define _SYMBEX_RT_SYM_HASHES     0x08
+/* Disable the fast paths that fork on symbolic values.  The string
+ * comparisons then check once whether either side is symbolic, and only
+ * symbolic strings go through the branch-free loops. */
+#define _SYMBEX_RT_NOFASTPATH     0x10
+
+/* 0 <= i < limit, in a single comparison, so that a symbolic index or size
+ * forks once.  `limit' must not be negative. */
+#define _SYMBEX_VALID_INDEX(i, limit) \
+    ((size_t)(i) < (size_t)(limit))
+
+/* Parse PYTHONSYMBEXOPT.  Called once at startup, before any string is
+   hashed. */
+PyAPI_FUNC(void) _PySymbex_Init(void);
+/* Apply a comma-separated option list on top of the current flags (the -X
+   symbexopt= command line option).  Returns -1 on an unknown option. */
+PyAPI_FUNC(int) _PySymbex_SetOptions(const char *opts);
 
 #ifdef SYMBEX_INSTRUMENTATION
 
@@ -17,57 +56,235 @@
     (s2e_is_symbolic(&(str), sizeof(str)) || \
      ((str) != NULL && s2e_is_symbolic((str), 0)))
 
+/* Is the value of the integer variable `size' symbolic? */
+#define IS_SYMBOLIC_SIZE(size) \
+    s2e_is_symbolic(&(size), sizeof(size))
+
+/* Like IS_SYMBOLIC_STR_SIZE, for `count' items of `itemsize' bytes */
+#define IS_SYMBOLIC_BUF_SIZE(buf, count, itemsize) \
+    (s2e_is_symbolic(&(count), sizeof(count)) || \
+     ((buf) != NULL && s2e_is_symbolic((buf), (count) * (itemsize))))
+
 
 #define _SYMBEX_INSTRUMENT        1
 
 
+/* The code paths below are always compiled in the instrumented build and
+ * enabled at runtime through _Py_SymbexFlags.  The flags never change after
+ * startup, so the checks are well-predicted branches in concrete mode.
+ */
+
 /* Concretize memory block sizes at allocation */
-#ifdef SYMBEX_OPT_CONCRETIZE_BUFFSIZES
 #define _SYMBEX_ALLOC             1
 #define _SYMBEX_VARSIZE           1
-#endif /* SYMBEX_OPT_CONCRETIZE_BUFFSIZES */
 
-#ifdef SYMBEX_OPT_NEUTRALIZE_HASHES
 /* Hash functions optimized for symbolic execution */
 #define _SYMBEX_HASHES            1
 /* A dict implementation that can fall back on linear search when symbolic
  * objects are added as keys.
  */
-/*#define _SYMBEX_DICT_HASHES       1*/
-#define _SYMBEX_CONST_HASHES      1
+#define _SYMBEX_DICT_HASHES       1
 /*#define _SYMBEX_GLOBAL_HASHES     1*/
-#endif /* SYMBEX_OPT_NEUTRALIZE_HASHES */
 
-#ifdef SYMBEX_OPT_DISABLE_INTERNING
-#define _SYMBEX_INTERNED          1
-#define _SYMBEX_INTERNED_STRING   1
-#endif /* SYMBEX_OPT_DISABLE_INTERNING */
+/* Bytecode-level instruction trace.  While a buffer is installed in the
+ * thread state, the main loop of PyEval_EvalFrameEx() appends a record for
+ * each executed instruction, without any Python-level callback or line
+ * number computation.  The owner of the buffer empties it in the flush
+ * callback, called once the buffer is full, and frees it in the release
+ * callback, called when the thread state is cleared with the buffer still
+ * installed.
+ */
+#define _SYMBEX_INSN_TRACE        1
+
+typedef struct {
+    int code_id;            /* co_symbex_id of the executing code object */
+    int last_inst;          /* f_lasti of the instruction */
+    int opcode;
+} _PySymbexInsnRecord;
+
+typedef struct _PySymbexInsnBuffer {
+    _PySymbexInsnRecord *records;
+    int count;
+    int capacity;
+    int opclass_mask;       /* Bit set of the _SYMBEX_OPCLASS_* to record */
+    void (*flush)(struct _PySymbexInsnBuffer *buffer);
+    void (*release)(struct _PySymbexInsnBuffer *buffer);
+} _PySymbexInsnBuffer;
+
+/* Opcode metadata.  The table is generated from Include/opcode.h by
+ * Chef/utils/gen_opcode_table.py (Python/symbex_opcodes.h) and defined in
+ * Python/ceval.c.
+ */
+#define _SYMBEX_OP_DEFINED        0x01
+#define _SYMBEX_OP_HASARG         0x02
+/* May continue elsewhere than at the next instruction */
+#define _SYMBEX_OP_BRANCH         0x04
+/* The branch depends on an operand value */
+#define _SYMBEX_OP_COND           0x08
+/* May run arbitrary Python or C code */
+#define _SYMBEX_OP_CALLOUT        0x10
+/* The stack effect depends on oparg or on the outcome; the table holds the
+ * effect for oparg 0 */
+#define _SYMBEX_OP_VAREFFECT      0x20
+
+/* How an opcode may fork on symbolic operands */
+enum {
+    _SYMBEX_OPCLASS_NONE = 0,   /* Stack, local and block handling */
+    _SYMBEX_OPCLASS_TRUTH,      /* Truth value of an operand */
+    _SYMBEX_OPCLASS_COMPARE,    /* Rich comparisons, "in" and "is" */
+    _SYMBEX_OPCLASS_ARITH,      /* Numeric and bitwise operators */
+    _SYMBEX_OPCLASS_SUBSCR,     /* Indexing and slicing */
+    _SYMBEX_OPCLASS_ITER,       /* Sequence lengths */
+    _SYMBEX_OPCLASS_LOOKUP,     /* Name and attribute lookups, dicts */
+    _SYMBEX_OPCLASS_CALL,       /* Calls into functions and classes */
+    _SYMBEX_OPCLASS_COUNT
+};
+
+typedef struct {
+    signed char stack_effect;
+    unsigned char flags;
+    unsigned char opclass;
+} _PySymbexOpcodeInfo;
+
+PyAPI_DATA(const _PySymbexOpcodeInfo) _PySymbex_OpcodeTable[256];
+
+/* Called by Python/dynload_shlib.c after it maps a new extension module,
+ * so that the host learns about the new code mappings. */
+typedef void (*_PySymbexDlopenHook)(const char *pathname);
+PyAPI_DATA(_PySymbexDlopenHook) _PySymbex_DlopenHook;
+
+PyAPI_DATA(int) _Py_SymbexFlags;
 
-#ifdef SYMBEX_OPT_DISABLE_FAST_PATHS
-#define _SYMBEX_SHORT_CIRCUITED   1
-#endif /* SYMBEX_OPT_DISABLE_FAST_PATHS */
+#define _SYMBEX_RT(flag)          (_Py_SymbexFlags & (flag))
+
+/* Should a comparison of the two buffers avoid forking on their contents? */
+#define _SYMBEX_SYMBOLIC_PAIR(s1, n1, s2, n2, itemsize) \
+    (_SYMBEX_RT(_SYMBEX_RT_NOFASTPATH) && \
+     (IS_SYMBOLIC_BUF_SIZE(s1, n1, itemsize) || \
+      IS_SYMBOLIC_BUF_SIZE(s2, n2, itemsize)))
+
+/* Concretization policies of the symbolic allocation sizes, applied by
+ * PREPARE_ALLOC when _SYMBEX_RT_CONCRBUFF is set, and selected by the
+ * alloc= option (Python/symbex.c).
+ */
+enum {
+    /* A single example of the size, without constraining the path.  The
+     * paths where the requested size is larger than the example are lost. */
+    _SYMBEX_ALLOC_EXAMPLE,
+    /* The upper bound of the size, rounded up to its size class, which is
+     * large enough for all the paths.  Bounds over MAX_ALLOC_SIZE fall back
+     * to the buckets. */
+    _SYMBEX_ALLOC_BOUND,
+    /* Fork once per feasible size class, and allocate the upper end of the
+     * class. */
+    _SYMBEX_ALLOC_BUCKETS,
+    /* Constrain the size to the size class of one example, and allocate the
+     * upper end of the class.  The size stays symbolic within the class,
+     * which is all that obmalloc looks at; the buffer is zeroed, but a copy
+     * of a symbolic length still forks once per length. */
+    _SYMBEX_ALLOC_CLASS,
+    _SYMBEX_ALLOC_POLICY_COUNT
+};
+
+/* Size classes of the symbolic allocations: the obmalloc classes up to
+ * _SYMBEX_ALLOC_SMALL bytes, and powers of two above. */
+#define _SYMBEX_ALLOC_ALIGNMENT   8
+#define _SYMBEX_ALLOC_SMALL       256
 
 #define MAX_ALLOC_SIZE		1024
 
-#if 0 // XXX: Investigate this optimization
+PyAPI_DATA(int) _PySymbex_AllocPolicy;
+PyAPI_DATA(const char * const) _PySymbex_AllocPolicyNames[];
+/* Number of symbolic sizes handled by each policy */
+PyAPI_DATA(Py_ssize_t) _PySymbex_AllocCounts[_SYMBEX_ALLOC_POLICY_COUNT];
+
+/* Return the concrete size to allocate for the symbolic `size' */
+PyAPI_FUNC(size_t) _PySymbex_PrepareAlloc(size_t size);
+
 #define PREPARE_ALLOC(size) \
 	do { \
-		if (s2e_is_symbolic(&(size), sizeof(size))) { \
-			size = s2e_get_upper_bound(size); \
-		} \
+		if (_SYMBEX_RT(_SYMBEX_RT_CONCRBUFF) && \
+		    s2e_is_symbolic(&(size), sizeof(size))) \
+			size = _PySymbex_PrepareAlloc(size); \
 	} while(0)
-#else
-#define PREPARE_ALLOC(size) \
+
+/* Return the concrete item count to allocate for a variable-size object of
+   `size' items, which may be symbolic.  The object keeps the symbolic size
+   in its header (_SYMBEX_VARSIZE), and the size is constrained to fit the
+   allocation. */
+PyAPI_FUNC(Py_ssize_t) _PySymbex_PrepareVarSize(Py_ssize_t size);
+
+#define PREPARE_VARSIZE(size) \
 	do { \
-		s2e_get_example(&(size), sizeof(size)); \
+		if (_SYMBEX_RT(_SYMBEX_RT_CONCRBUFF) && IS_SYMBOLIC_SIZE(size)) \
+			size = _PySymbex_PrepareVarSize(size); \
 	} while(0)
-#endif
+
+/* The concrete capacity of a tuple with a symbolic size, which owns its
+   items up to the capacity, past the size (see tupledealloc()).
+   _PySymbex_TakeCapacity() forgets the capacity of `op' and returns it, or
+   returns `size' if none was recorded. */
+PyAPI_FUNC(void) _PySymbex_SetCapacity(PyObject *op, Py_ssize_t capacity);
+PyAPI_FUNC(Py_ssize_t) _PySymbex_TakeCapacity(PyObject *op, Py_ssize_t size);
+
+/* Should the value of `size' bytes at `ptr' bypass the caches of shared
+ * objects?  A cache lookup indexed by a symbolic value forks once per
+ * feasible value. */
+#define _SYMBEX_SKIP_INTERN(ptr, size) \
+    (_SYMBEX_RT(_SYMBEX_RT_NOINTERN) && s2e_is_symbolic((ptr), (size)))
 
 #define _SYMBEX_HASH_VALUE       0xABC
 
+/* Should a string buffer of `size' bytes at `str' get the neutral hash? */
+#define _SYMBEX_NEUTRAL_HASH(str, size) \
+    (_SYMBEX_RT(_SYMBEX_RT_CONST_HASHES) || \
+     (_SYMBEX_RT(_SYMBEX_RT_SYM_HASHES) && IS_SYMBOLIC_STR_SIZE(str, size)))
+
+/* Is `hash' a neutral hash that may stand for a different real hash? */
+#define _SYMBEX_IS_NEUTRAL_HASH(hash) \
+    (_SYMBEX_RT(_SYMBEX_RT_SYM_HASHES) && (hash) == _SYMBEX_HASH_VALUE)
+
+/* A hash value is "known" if it is concrete and is not a neutral hash.  Two
+ * equal objects may only have different hashes if one of them is unknown.
+ * The symbolic test comes first, so that a symbolic hash is never compared.
+ */
+#define _SYMBEX_HASH_IS_KNOWN(hash) \
+    (!s2e_is_symbolic(&(hash), sizeof(hash)) && !_SYMBEX_IS_NEUTRAL_HASH(hash))
+
+/* Is the hash of an item of a container neutral?  The hash of the
+ * container is then neutral too, rather than a known value computed from
+ * the neutral one. */
+#define _SYMBEX_IS_NEUTRAL_ITEM_HASH(hash) \
+    (_SYMBEX_RT(_SYMBEX_RT_SYM_HASHES) && \
+     !s2e_is_symbolic(&(hash), sizeof(hash)) && \
+     (hash) == _SYMBEX_HASH_VALUE)
+
+/* Character classes of the number parsers, by range checks: indexing a
+   table by a symbolic character forks once per feasible value.  The
+   classes are those of the C locale. */
+#define _SYMBEX_ISSPACE(c) \
+    (((c) == ' ') | (((c) >= '\t') & ((c) <= '\r')))
+#define _SYMBEX_ISDIGIT(c) \
+    (((c) >= '0') & ((c) <= '9'))
+#define _SYMBEX_ISALPHA(c) \
+    ((((c) >= 'A') & ((c) <= 'Z')) | (((c) >= 'a') & ((c) <= 'z')))
+#define _SYMBEX_ISALNUM(c) \
+    (_SYMBEX_ISDIGIT(c) | _SYMBEX_ISALPHA(c))
+
 #else
 #define IS_SYMBOLIC_STR_SIZE(str, size) 0
 #define IS_SYMBOLIC_STR(str)            0
+#define IS_SYMBOLIC_BUF_SIZE(buf, count, itemsize) 0
+#define IS_SYMBOLIC_SIZE(size)          0
+
+#define _SYMBEX_RT(flag)                0
+#define _SYMBEX_SYMBOLIC_PAIR(s1, n1, s2, n2, itemsize) 0
+#define _SYMBEX_SKIP_INTERN(ptr, size)  0
+
+#define _SYMBEX_ISSPACE(c)              isspace(c)
+#define _SYMBEX_ISDIGIT(c)              isdigit(c)
+#define _SYMBEX_ISALPHA(c)              isalpha(c)
+#define _SYMBEX_ISALNUM(c)              isalnum(c)
 #endif /* SYMBEX_INSTRUMENTATION */
 
 #endif /* !SYMBEX_H_ */
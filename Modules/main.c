@@ -1,6 +1,7 @@
 /* Python interpreter main program */
 
 #include "Python.h"
+#include "symbex.h"
 #include "osdefs.h"
 #include "code.h" /* For CO_FUTURE_DIVISION */
 #include "import.h"
@@ -40,7 +41,7 @@ static char **orig_argv;
 static int  orig_argc;
 
 /* command line options */
-#define BASE_OPTS "3bBc:dEhiJm:OQ:RsStuUvVW:xX?"
+#define BASE_OPTS "3bBc:dEhiJm:OQ:RsStuUvVW:xX:?"
 
 #ifndef RISCOS
 #define PROGRAM_OPTS BASE_OPTS
@@ -52,6 +53,9 @@ static int  orig_argc;
 extern int Py_RISCOSWimpFlag;
 #endif /*RISCOS*/
 
+/* -X option selecting the symbolic execution optimizations */
+#define SYMBEXOPT_PREFIX "symbexopt="
+
 /* Short usage message (with %s for argv0) */
 static char *usage_line =
 "usage: %s [option] ... [-c cmd | -m mod | file | -] [arg] ...\n";
@@ -88,6 +92,7 @@ static char *usage_3 = "\
 -W arg : warning control; arg is action:message:category:module:lineno\n\
          also PYTHONWARNINGS=arg\n\
 -x     : skip first line of source, allowing use of non-Unix forms of #!cmd\n\
+-X symbexopt=opts : symbolic execution options; also PYTHONSYMBEXOPT=opts\n\
 ";
 static char *usage_4 = "\
 -3     : warn about Python 3.x incompatibilities that 2to3 cannot trivially fix\n\
@@ -251,6 +256,7 @@ Py_Main(int argc, char **argv)
     int help = 0;
     int version = 0;
     int saw_unbuffered_flag = 0;
+    char *symbex_opts = NULL;
     PyCompilerFlags cf;
 
     cf.cf_flags = 0;
@@ -277,6 +283,11 @@ Py_Main(int argc, char **argv)
         case 'R':
             Py_HashRandomizationFlag++;
             break;
+        case 'X':
+            if (strncmp(_PyOS_optarg, SYMBEXOPT_PREFIX,
+                        strlen(SYMBEXOPT_PREFIX)) == 0)
+                symbex_opts = _PyOS_optarg + strlen(SYMBEXOPT_PREFIX);
+            break;
         }
     }
     /* The variable is only tested for existence here; _PyRandom_Init will
@@ -286,6 +297,13 @@ Py_Main(int argc, char **argv)
         Py_HashRandomizationFlag = 1;
 
     _PyRandom_Init();
+    /* The command line options take precedence over PYTHONSYMBEXOPT */
+    _PySymbex_Init();
+    if (symbex_opts != NULL && _PySymbex_SetOptions(symbex_opts) < 0) {
+        fprintf(stderr, "Unknown symbolic execution option in -X %s%s\n",
+                SYMBEXOPT_PREFIX, symbex_opts);
+        return usage(2, argv[0]);
+    }
 
     PySys_ResetWarnOptions();
     _PyOS_ResetGetOpt();
@@ -408,7 +426,14 @@ Py_Main(int argc, char **argv)
             skipfirstline = 1;
             break;
 
-        /* case 'X': reserved for implementation-specific arguments */
+        case 'X':
+            /* Only -X symbexopt=, already handled above */
+            if (strncmp(_PyOS_optarg, SYMBEXOPT_PREFIX,
+                        strlen(SYMBEXOPT_PREFIX)) != 0) {
+                fprintf(stderr, "Unknown -X option: %s\n", _PyOS_optarg);
+                return usage(2, argv[0]);
+            }
+            break;
 
         case 'U':
             Py_UnicodeFlag++;
@@ -4,6 +4,7 @@
 #include "Python.h"
 #include "structmember.h"
 #include "bytes_methods.h"
+#include "symbex.h"
 
 char _PyByteArray_empty_string[] = "";
 
@@ -169,12 +170,18 @@ PyByteArray_FromStringAndSize(const char *bytes, Py_ssize_t size)
 {
     PyByteArrayObject *new;
     Py_ssize_t alloc;
+#ifdef _SYMBEX_VARSIZE
+    Py_ssize_t sym_size = size;
+#endif
 
     if (size < 0) {
         PyErr_SetString(PyExc_SystemError,
             "Negative size passed to PyByteArray_FromStringAndSize");
         return NULL;
     }
+#ifdef _SYMBEX_VARSIZE
+    PREPARE_VARSIZE(size);
+#endif
 
     new = PyObject_New(PyByteArrayObject, &PyByteArray_Type);
     if (new == NULL)
@@ -191,9 +198,23 @@ PyByteArray_FromStringAndSize(const char *bytes, Py_ssize_t size)
             Py_DECREF(new);
             return PyErr_NoMemory();
         }
-        if (bytes != NULL && size > 0)
-            memcpy(new->ob_bytes, bytes, size);
-        new->ob_bytes[size] = '\0';  /* Trailing null byte */
+#ifdef _SYMBEX_VARSIZE
+        if (IS_SYMBOLIC_SIZE(sym_size) && !IS_SYMBOLIC_SIZE(size)) {
+            /* The buffer spans the size class, the contents only the
+               size.  Zero the buffer whole instead of storing the null
+               byte at a symbolic index. */
+            memset(new->ob_bytes, 0, alloc);
+            size = sym_size;
+            if (bytes != NULL)
+                memcpy(new->ob_bytes, bytes, size);
+        }
+        else
+#endif
+        {
+            if (bytes != NULL && size > 0)
+                memcpy(new->ob_bytes, bytes, size);
+            new->ob_bytes[size] = '\0';  /* Trailing null byte */
+        }
     }
     Py_SIZE(new) = size;
     new->ob_alloc = alloc;
@@ -409,7 +430,7 @@ bytearray_getitem(PyByteArrayObject *self, Py_ssize_t i)
 {
     if (i < 0)
         i += Py_SIZE(self);
-    if (i < 0 || i >= Py_SIZE(self)) {
+    if (!_SYMBEX_VALID_INDEX(i, Py_SIZE(self))) {
         PyErr_SetString(PyExc_IndexError, "bytearray index out of range");
         return NULL;
     }
@@ -428,7 +449,7 @@ bytearray_subscript(PyByteArrayObject *self, PyObject *index)
         if (i < 0)
             i += PyByteArray_GET_SIZE(self);
 
-        if (i < 0 || i >= Py_SIZE(self)) {
+        if (!_SYMBEX_VALID_INDEX(i, Py_SIZE(self))) {
             PyErr_SetString(PyExc_IndexError, "bytearray index out of range");
             return NULL;
         }
@@ -569,7 +590,7 @@ bytearray_setitem(PyByteArrayObject *self, Py_ssize_t i, PyObject *value)
     if (i < 0)
         i += Py_SIZE(self);
 
-    if (i < 0 || i >= Py_SIZE(self)) {
+    if (!_SYMBEX_VALID_INDEX(i, Py_SIZE(self))) {
         PyErr_SetString(PyExc_IndexError, "bytearray index out of range");
         return -1;
     }
@@ -599,7 +620,7 @@ bytearray_ass_subscript(PyByteArrayObject *self, PyObject *index, PyObject *valu
         if (i < 0)
             i += PyByteArray_GET_SIZE(self);
 
-        if (i < 0 || i >= Py_SIZE(self)) {
+        if (!_SYMBEX_VALID_INDEX(i, Py_SIZE(self))) {
             PyErr_SetString(PyExc_IndexError, "bytearray index out of range");
             return -1;
         }
@@ -39,6 +39,48 @@ intern_strings(PyObject *tuple)
     }
 }
 
+#ifdef SYMBEX_INSTRUMENTATION
+/* The code object registry (see _PyCode_SymbexLookup).  The entries are
+   borrowed references, cleared by code_dealloc(). */
+static PyCodeObject **symbex_registry = NULL;
+static int symbex_registry_size = 0;
+static int symbex_registry_capacity = 0;
+
+static int
+symbex_register_code(PyCodeObject *co)
+{
+    if (symbex_registry_size == symbex_registry_capacity) {
+        int capacity = symbex_registry_capacity ?
+            2 * symbex_registry_capacity : 1024;
+        PyCodeObject **registry = PyMem_Realloc(symbex_registry,
+            capacity * sizeof(PyCodeObject *));
+        if (registry == NULL) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        symbex_registry = registry;
+        symbex_registry_capacity = capacity;
+    }
+    co->co_symbex_id = symbex_registry_size;
+    symbex_registry[symbex_registry_size++] = co;
+    return 0;
+}
+
+int
+_PyCode_SymbexRegistrySize(void)
+{
+    return symbex_registry_size;
+}
+
+PyCodeObject *
+_PyCode_SymbexLookup(int id)
+{
+    if (id < 0 || id >= symbex_registry_size)
+        return NULL;
+    return symbex_registry[id];
+}
+#endif /* SYMBEX_INSTRUMENTATION */
+
 
 PyCodeObject *
 PyCode_New(int argcount, int nlocals, int stacksize, int flags,
@@ -104,6 +146,13 @@ PyCode_New(int argcount, int nlocals, int stacksize, int flags,
         co->co_lnotab = lnotab;
         co->co_zombieframe = NULL;
         co->co_weakreflist = NULL;
+#ifdef SYMBEX_INSTRUMENTATION
+        co->co_symbex_id = -1;
+        if (symbex_register_code(co) < 0) {
+            Py_DECREF(co);
+            return NULL;
+        }
+#endif
     }
     return co;
 }
@@ -317,6 +366,10 @@ code_dealloc(PyCodeObject *co)
         PyObject_GC_Del(co->co_zombieframe);
     if (co->co_weakreflist != NULL)
         PyObject_ClearWeakRefs((PyObject*)co);
+#ifdef SYMBEX_INSTRUMENTATION
+    if (co->co_symbex_id >= 0)
+        symbex_registry[co->co_symbex_id] = NULL;
+#endif
     PyObject_DEL(co);
 }
 
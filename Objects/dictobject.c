@@ -150,6 +150,24 @@ _PyDict_Dummy(void)
 static PyDictEntry *
 lookdict_string(PyDictObject *mp, PyObject *key, long hash);
 
+#ifdef _SYMBEX_DICT_HASHES
+static void
+dict_make_flat(PyDictObject *mp);
+
+/* Switch the dict to flat mode (see lookdict_flat() below) the first time
+ * an unknown hash value is used to access it, if one of the hash options is
+ * enabled.  Flat mode is sticky.
+ */
+#define FLATTEN_IF_SYMBOLIC(mp, hash) \
+    do { \
+        if (_SYMBEX_RT(_SYMBEX_RT_CONST_HASHES | _SYMBEX_RT_SYM_HASHES) && \
+            !(mp)->ma_flat && !_SYMBEX_HASH_IS_KNOWN(hash)) \
+            dict_make_flat(mp); \
+    } while(0)
+#else
+#define FLATTEN_IF_SYMBOLIC(mp, hash)
+#endif
+
 #ifdef SHOW_CONVERSION_COUNTS
 static long created = 0L;
 static long converted = 0L;
@@ -460,6 +478,74 @@ lookdict_string(PyDictObject *mp, PyObject *key, register long hash)
     return 0;
 }
 
+#ifdef _SYMBEX_DICT_HASHES
+/*
+ * Lookup function used by dicts in flat mode.  Once a symbolic hash value
+ * reaches a dict, probing the hash table would fork on every collision and
+ * on every masked table index.  Instead, a flat dict keeps its entries
+ * packed at the front of ma_table, in insertion order, and finds keys by a
+ * linear scan that never looks at the hash values:
+ *
+ *   - ma_table[0 .. ma_fill-1] holds active and dummy entries;
+ *   - ma_table[ma_fill .. ma_mask] is unused, and ma_fill <= ma_mask always
+ *     holds, so there is at least one free slot at the end.
+ *
+ * Hashes are still used to skip entries, but only when both sides are
+ * known (see _SYMBEX_HASH_IS_KNOWN), so that lookups of concrete keys
+ * avoid needless (and possibly failing) comparisons without adding any
+ * symbolic branch.
+ *
+ * A miss returns the first unused slot, so insertdict() appends.  Deleted
+ * entries leave dummies behind that are purged by the next dictresize().
+ * The table keeps its power-of-2 size, so PyDict_Next(), the iterators and
+ * every other full-table scan work unchanged.
+ */
+static PyDictEntry *
+lookdict_flat(PyDictObject *mp, PyObject *key, long hash)
+{
+    PyDictEntry *ep0 = mp->ma_table;
+    PyDictEntry *end = ep0 + mp->ma_fill;
+    register PyDictEntry *ep;
+    register int cmp;
+    int known_hash = _SYMBEX_HASH_IS_KNOWN(hash);
+    PyObject *startkey;
+
+    /* Identity checks are on concrete pointers, so do them all first */
+    for (ep = ep0; ep < end; ep++) {
+        if (ep->me_key == key)
+            return ep;
+    }
+
+    for (ep = ep0; ep < end; ep++) {
+        if (ep->me_key == dummy)
+            continue;
+        if (known_hash && _SYMBEX_HASH_IS_KNOWN(ep->me_hash) &&
+            ep->me_hash != hash)
+            continue;
+        if (PyString_CheckExact(key) && PyString_CheckExact(ep->me_key)) {
+            if (_PyString_Eq(ep->me_key, key))
+                return ep;
+            continue;
+        }
+        startkey = ep->me_key;
+        Py_INCREF(startkey);
+        cmp = PyObject_RichCompareBool(startkey, key, Py_EQ);
+        Py_DECREF(startkey);
+        if (cmp < 0)
+            return NULL;
+        if (ep0 != mp->ma_table || ep->me_key != startkey ||
+            end != ep0 + mp->ma_fill) {
+            /* The compare mutated the dict:  start over. */
+            return lookdict_flat(mp, key, hash);
+        }
+        if (cmp > 0)
+            return ep;
+    }
+    assert(mp->ma_fill <= mp->ma_mask);
+    return end;
+}
+#endif /* _SYMBEX_DICT_HASHES */
+
 #ifdef SHOW_TRACK_COUNT
 #define INCREASE_TRACK_COUNT \
     (count_tracked++, count_untracked--);
@@ -582,6 +668,64 @@ insertdict_clean(register PyDictObject *mp, PyObject *key, long hash,
     mp->ma_used++;
 }
 
+#ifdef _SYMBEX_DICT_HASHES
+/*
+Flat-mode counterpart of insertdict_clean():  the table is packed, so the
+entry is simply appended after the last one.
+*/
+static void
+insertdict_flat_clean(register PyDictObject *mp, PyObject *key, long hash,
+                      PyObject *value)
+{
+    register PyDictEntry *ep = &mp->ma_table[mp->ma_fill];
+
+    MAINTAIN_TRACKING(mp, key, value);
+    assert(ep->me_key == NULL && ep->me_value == NULL);
+    mp->ma_fill++;
+    ep->me_key = key;
+    ep->me_hash = (Py_ssize_t)hash;
+    ep->me_value = value;
+    mp->ma_used++;
+}
+
+/*
+Switch a dict to flat mode, in place.  Active entries are moved to the front
+of the table, keeping their relative order, and dummies are dropped.  The
+hash values stay in the entries, since _PyDict_Next() hands them out to
+callers such as the set implementation.  This never allocates, so it can't
+fail.
+*/
+static void
+dict_make_flat(PyDictObject *mp)
+{
+    PyDictEntry *ep0 = mp->ma_table;
+    Py_ssize_t i, j;
+
+    assert(!mp->ma_flat);
+    for (i = 0, j = 0; i <= mp->ma_mask; i++) {
+        if (ep0[i].me_value != NULL) {
+            if (i != j) {
+                ep0[j] = ep0[i];
+                ep0[i].me_key = NULL;
+                ep0[i].me_value = NULL;
+                ep0[i].me_hash = 0;
+            }
+            j++;
+        }
+        else if (ep0[i].me_key != NULL) {
+            assert(ep0[i].me_key == dummy);
+            ep0[i].me_key = NULL;
+            ep0[i].me_hash = 0;
+            Py_DECREF(dummy);
+        }
+    }
+    assert(j == mp->ma_used);
+    mp->ma_fill = j;
+    mp->ma_flat = 1;
+    mp->ma_lookup = lookdict_flat;
+}
+#endif /* _SYMBEX_DICT_HASHES */
+
 /*
 Restructure the table by allocating a new table and reinserting all
 items again.  When entries have been deleted, the new table may
@@ -655,13 +799,13 @@ dictresize(PyDictObject *mp, Py_ssize_t minused)
         if (ep->me_value != NULL) {             /* active entry */
             --i;
 #ifdef _SYMBEX_DICT_HASHES
-            insertdict_clean(mp, ep->me_key,
-            		         mp->ma_flat ? _SYMBEX_HASH_VALUE : (long)ep->me_hash,
-            		         ep->me_value);
-#else
+            if (mp->ma_flat)
+                insertdict_flat_clean(mp, ep->me_key, (long)ep->me_hash,
+                                      ep->me_value);
+            else
+#endif
             insertdict_clean(mp, ep->me_key, (long)ep->me_hash,
                              ep->me_value);
-#endif
         }
         else if (ep->me_key != NULL) {          /* dummy entry */
             --i;
@@ -712,11 +856,6 @@ PyDict_GetItem(PyObject *op, PyObject *key)
     PyThreadState *tstate;
     if (!PyDict_Check(op))
         return NULL;
-#ifdef _SYMBEX_DICT_HASHES
-    if (mp->ma_flat) {
-    	hash = _SYMBEX_HASH_VALUE;
-    } else
-#endif
     if (!PyString_CheckExact(key) ||
         (hash = ((PyStringObject *) key)->ob_shash) == -1)
     {
@@ -726,15 +865,7 @@ PyDict_GetItem(PyObject *op, PyObject *key)
             return NULL;
         }
     }
-#ifdef _SYMBEX_DICT_HASHES
-    if (s2e_is_symbolic(&hash, sizeof(hash)) && !mp->ma_flat) {
-    	mp->ma_flat = 1;
-    	if (dictresize(mp, 2*((mp->ma_used > PyDict_MINSIZE)
-    			? mp->ma_used : PyDict_MINSIZE)) < 0) {
-    		return NULL;
-    	}
-    }
-#endif
+    FLATTEN_IF_SYMBOLIC(mp, hash);
 
     /* We can arrive here with a NULL tstate during initialization: try
        running "python -Wi" for an example related to string interning.
@@ -786,11 +917,6 @@ PyDict_SetItem(register PyObject *op, PyObject *key, PyObject *value)
     assert(key);
     assert(value);
     mp = (PyDictObject *)op;
-#ifdef _SYMBEX_DICT_HASHES
-    if (mp->ma_flat) {
-    	hash = _SYMBEX_HASH_VALUE;
-    } else
-#endif
     if (PyString_CheckExact(key)) {
         hash = ((PyStringObject *)key)->ob_shash;
         if (hash == -1)
@@ -801,15 +927,7 @@ PyDict_SetItem(register PyObject *op, PyObject *key, PyObject *value)
         if (hash == -1)
             return -1;
     }
-#ifdef _SYMBEX_DICT_HASHES
-    if (s2e_is_symbolic(&hash, sizeof(hash)) && !mp->ma_flat) {
-    	mp->ma_flat = 1;
-    	if (dictresize(mp, 2*((mp->ma_used > PyDict_MINSIZE)
-    			? mp->ma_used : PyDict_MINSIZE)) < 0) {
-    		return -1;
-    	}
-    }
-#endif
+    FLATTEN_IF_SYMBOLIC(mp, hash);
     assert(mp->ma_fill <= mp->ma_mask);  /* at least one empty slot */
     n_used = mp->ma_used;
     Py_INCREF(value);
@@ -853,26 +971,13 @@ PyDict_DelItem(PyObject *op, PyObject *key)
     }
     assert(key);
     mp = (PyDictObject *)op;
-#ifdef _SYMBEX_DICT_HASHES
-    if (mp->ma_flat) {
-    	hash = _SYMBEX_HASH_VALUE;
-    } else
-#endif
     if (!PyString_CheckExact(key) ||
         (hash = ((PyStringObject *) key)->ob_shash) == -1) {
         hash = PyObject_Hash(key);
         if (hash == -1)
             return -1;
     }
-#ifdef _SYMBEX_DICT_HASHES
-    if (s2e_is_symbolic(&hash, sizeof(hash)) && !mp->ma_flat) {
-    	mp->ma_flat = 1;
-    	if (dictresize(mp, 2*((mp->ma_used > PyDict_MINSIZE)
-    			? mp->ma_used : PyDict_MINSIZE)) < 0) {
-    		return -1;
-    	}
-    }
-#endif
+    FLATTEN_IF_SYMBOLIC(mp, hash);
     ep = (mp->ma_lookup)(mp, key, hash);
     if (ep == NULL)
         return -1;
@@ -1202,26 +1307,13 @@ dict_subscript(PyDictObject *mp, register PyObject *key)
     long hash;
     PyDictEntry *ep;
     assert(mp->ma_table != NULL);
-#ifdef _SYMBEX_DICT_HASHES
-    if (mp->ma_flat) {
-    	hash = _SYMBEX_HASH_VALUE;
-    } else
-#endif
     if (!PyString_CheckExact(key) ||
         (hash = ((PyStringObject *) key)->ob_shash) == -1) {
         hash = PyObject_Hash(key);
         if (hash == -1)
             return NULL;
     }
-#ifdef _SYMBEX_DICT_HASHES
-    if (s2e_is_symbolic(&hash, sizeof(hash)) && !mp->ma_flat) {
-    	mp->ma_flat = 1;
-    	if (dictresize(mp, 2*((mp->ma_used > PyDict_MINSIZE)
-    			? mp->ma_used : PyDict_MINSIZE)) < 0) {
-    		return NULL;
-    	}
-    }
-#endif
+    FLATTEN_IF_SYMBOLIC(mp, hash);
     ep = (mp->ma_lookup)(mp, key, hash);
     if (ep == NULL)
         return NULL;
@@ -1415,6 +1507,7 @@ dict_fromkeys(PyObject *cls, PyObject *args)
         }
 
         while (_PyDict_Next(seq, &pos, &key, &oldvalue, &hash)) {
+            FLATTEN_IF_SYMBOLIC(mp, hash);
             Py_INCREF(key);
             Py_INCREF(value);
             if (insertdict(mp, key, hash, value)) {
@@ -1437,6 +1530,7 @@ dict_fromkeys(PyObject *cls, PyObject *args)
         }
 
         while (_PySet_NextEntry(seq, &pos, &key, &hash)) {
+            FLATTEN_IF_SYMBOLIC(mp, hash);
             Py_INCREF(key);
             Py_INCREF(value);
             if (insertdict(mp, key, hash, value)) {
@@ -1635,6 +1729,7 @@ PyDict_Merge(PyObject *a, PyObject *b, int override)
             if (entry->me_value != NULL &&
                 (override ||
                  PyDict_GetItem(a, entry->me_key) == NULL)) {
+                FLATTEN_IF_SYMBOLIC(mp, entry->me_hash);
                 Py_INCREF(entry->me_key);
                 Py_INCREF(entry->me_value);
                 if (insertdict(mp, entry->me_key,
@@ -1958,26 +2053,13 @@ dict_contains(register PyDictObject *mp, PyObject *key)
     long hash;
     PyDictEntry *ep;
 
-#ifdef _SYMBEX_DICT_HASHES
-    if (mp->ma_flat) {
-    	hash = _SYMBEX_HASH_VALUE;
-    } else
-#endif
     if (!PyString_CheckExact(key) ||
         (hash = ((PyStringObject *) key)->ob_shash) == -1) {
         hash = PyObject_Hash(key);
         if (hash == -1)
             return NULL;
     }
-#ifdef _SYMBEX_DICT_HASHES
-    if (s2e_is_symbolic(&hash, sizeof(hash)) && !mp->ma_flat) {
-    	mp->ma_flat = 1;
-    	if (dictresize(mp, 2*((mp->ma_used > PyDict_MINSIZE)
-    			? mp->ma_used : PyDict_MINSIZE)) < 0) {
-    		return NULL;
-    	}
-    }
-#endif
+    FLATTEN_IF_SYMBOLIC(mp, hash);
     ep = (mp->ma_lookup)(mp, key, hash);
     if (ep == NULL)
         return NULL;
@@ -2005,26 +2087,13 @@ dict_get(register PyDictObject *mp, PyObject *args)
     if (!PyArg_UnpackTuple(args, "get", 1, 2, &key, &failobj))
         return NULL;
 
-#ifdef _SYMBEX_DICT_HASHES
-    if (mp->ma_flat) {
-    	hash = _SYMBEX_HASH_VALUE;
-    } else
-#endif
     if (!PyString_CheckExact(key) ||
         (hash = ((PyStringObject *) key)->ob_shash) == -1) {
         hash = PyObject_Hash(key);
         if (hash == -1)
             return NULL;
     }
-#ifdef _SYMBEX_DICT_HASHES
-    if (s2e_is_symbolic(&hash, sizeof(hash)) && !mp->ma_flat) {
-    	mp->ma_flat = 1;
-    	if (dictresize(mp, 2*((mp->ma_used > PyDict_MINSIZE)
-    			? mp->ma_used : PyDict_MINSIZE)) < 0) {
-    		return NULL;
-    	}
-    }
-#endif
+    FLATTEN_IF_SYMBOLIC(mp, hash);
     ep = (mp->ma_lookup)(mp, key, hash);
     if (ep == NULL)
         return NULL;
@@ -2048,26 +2117,13 @@ dict_setdefault(register PyDictObject *mp, PyObject *args)
     if (!PyArg_UnpackTuple(args, "setdefault", 1, 2, &key, &failobj))
         return NULL;
 
-#ifdef _SYMBEX_DICT_HASHES
-    if (mp->ma_flat) {
-    	hash = _SYMBEX_HASH_VALUE;
-    } else
-#endif
     if (!PyString_CheckExact(key) ||
         (hash = ((PyStringObject *) key)->ob_shash) == -1) {
         hash = PyObject_Hash(key);
         if (hash == -1)
             return NULL;
     }
-#ifdef _SYMBEX_DICT_HASHES
-    if (s2e_is_symbolic(&hash, sizeof(hash)) && !mp->ma_flat) {
-    	mp->ma_flat = 1;
-    	if (dictresize(mp, 2*((mp->ma_used > PyDict_MINSIZE)
-    			? mp->ma_used : PyDict_MINSIZE)) < 0) {
-    		return NULL;
-    	}
-    }
-#endif
+    FLATTEN_IF_SYMBOLIC(mp, hash);
     ep = (mp->ma_lookup)(mp, key, hash);
     if (ep == NULL)
         return NULL;
@@ -2107,26 +2163,13 @@ dict_pop(PyDictObject *mp, PyObject *args)
         set_key_error(key);
         return NULL;
     }
-#ifdef _SYMBEX_DICT_HASHES
-    if (mp->ma_flat) {
-    	hash = _SYMBEX_HASH_VALUE;
-    } else
-#endif
     if (!PyString_CheckExact(key) ||
         (hash = ((PyStringObject *) key)->ob_shash) == -1) {
         hash = PyObject_Hash(key);
         if (hash == -1)
             return NULL;
     }
-#ifdef _SYMBEX_DICT_HASHES
-    if (s2e_is_symbolic(&hash, sizeof(hash)) && !mp->ma_flat) {
-    	mp->ma_flat = 1;
-    	if (dictresize(mp, 2*((mp->ma_used > PyDict_MINSIZE)
-    			? mp->ma_used : PyDict_MINSIZE)) < 0) {
-    		return NULL;
-    	}
-    }
-#endif
+    FLATTEN_IF_SYMBOLIC(mp, hash);
     ep = (mp->ma_lookup)(mp, key, hash);
     if (ep == NULL)
         return NULL;
@@ -2387,26 +2430,13 @@ PyDict_Contains(PyObject *op, PyObject *key)
     PyDictObject *mp = (PyDictObject *)op;
     PyDictEntry *ep;
 
-#ifdef _SYMBEX_DICT_HASHES
-    if (mp->ma_flat) {
-    	hash = _SYMBEX_HASH_VALUE;
-    } else
-#endif
     if (!PyString_CheckExact(key) ||
         (hash = ((PyStringObject *) key)->ob_shash) == -1) {
         hash = PyObject_Hash(key);
         if (hash == -1)
             return -1;
     }
-#ifdef _SYMBEX_DICT_HASHES
-    if (s2e_is_symbolic(&hash, sizeof(hash)) && !mp->ma_flat) {
-    	mp->ma_flat = 1;
-    	if (dictresize(mp, 2*((mp->ma_used > PyDict_MINSIZE)
-    			? mp->ma_used : PyDict_MINSIZE)) < 0) {
-    		return -1;
-    	}
-    }
-#endif
+    FLATTEN_IF_SYMBOLIC(mp, hash);
     ep = (mp->ma_lookup)(mp, key, hash);
     return ep == NULL ? -1 : (ep->me_value != NULL);
 }
@@ -2418,6 +2448,7 @@ _PyDict_Contains(PyObject *op, PyObject *key, long hash)
     PyDictObject *mp = (PyDictObject *)op;
     PyDictEntry *ep;
 
+    FLATTEN_IF_SYMBOLIC(mp, hash);
     ep = (mp->ma_lookup)(mp, key, hash);
     return ep == NULL ? -1 : (ep->me_value != NULL);
 }
@@ -66,14 +66,12 @@ fill_free_list(void)
     return p + N_INTOBJECTS - 1;
 }
 
-#ifndef _SYMBEX_INTERNED
 #ifndef NSMALLPOSINTS
 #define NSMALLPOSINTS           257
 #endif
 #ifndef NSMALLNEGINTS
 #define NSMALLNEGINTS           5
 #endif
-#endif /* ifndef _SYMBEX_INTERNED */
 
 #if NSMALLNEGINTS + NSMALLPOSINTS > 0
 /* References to small integers are saved in this array so that they
@@ -93,7 +91,11 @@ PyInt_FromLong(long ival)
 {
     register PyIntObject *v;
 #if NSMALLNEGINTS + NSMALLPOSINTS > 0
-    if (-NSMALLNEGINTS <= ival && ival < NSMALLPOSINTS) {
+    /* A symbolic value always gets a fresh object.  The range check and the
+       lookup would fork on each small value, and the cache must only hold
+       concrete values. */
+    if (!IS_SYMBOLIC_SIZE(ival) &&
+        -NSMALLNEGINTS <= ival && ival < NSMALLPOSINTS) {
         v = small_ints[ival + NSMALLNEGINTS];
         Py_INCREF(v);
 #ifdef COUNT_ALLOCS
@@ -357,7 +359,7 @@ PyInt_FromString(char *s, char **pend, int base)
         return NULL;
     }
 
-    while (*s && isspace(Py_CHARMASK(*s)))
+    while (*s && _SYMBEX_ISSPACE(Py_CHARMASK(*s)))
         s++;
     errno = 0;
     if (base == 0 && s[0] == '0') {
@@ -367,9 +369,9 @@ PyInt_FromString(char *s, char **pend, int base)
     }
     else
         x = PyOS_strtol(s, &end, base);
-    if (end == s || !isalnum(Py_CHARMASK(end[-1])))
+    if (end == s || !_SYMBEX_ISALNUM(Py_CHARMASK(end[-1])))
         goto bad;
-    while (*end && isspace(Py_CHARMASK(*end)))
+    while (*end && _SYMBEX_ISSPACE(Py_CHARMASK(*end)))
         end++;
     if (*end != '\0') {
   bad:
@@ -853,10 +855,8 @@ int_lshift(PyIntObject *v, PyIntObject *w)
         PyErr_SetString(PyExc_ValueError, "negative shift count");
         return NULL;
     }
-#ifndef _SYMBEX_SHORT_CIRCUITED
-    if (a == 0 || b == 0)
+    if (!_SYMBEX_RT(_SYMBEX_RT_NOFASTPATH) && (a == 0 || b == 0))
         return int_int(v);
-#endif
     if (b >= LONG_BIT) {
         vv = PyLong_FromLong(PyInt_AS_LONG(v));
         if (vv == NULL)
@@ -1490,7 +1490,8 @@ PyInt_ClearFreeList(void)
                     free_list = p;
                 }
 #if NSMALLNEGINTS + NSMALLPOSINTS > 0
-                else if (-NSMALLNEGINTS <= p->ob_ival &&
+                else if (!IS_SYMBOLIC_SIZE(p->ob_ival) &&
+                         -NSMALLNEGINTS <= p->ob_ival &&
                          p->ob_ival < NSMALLPOSINTS &&
                          small_ints[p->ob_ival +
                                     NSMALLNEGINTS] == NULL) {
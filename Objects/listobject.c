@@ -1,6 +1,7 @@
 /* List object implementation */
 
 #include "Python.h"
+#include "symbex.h"
 
 #ifdef STDC_HEADERS
 #include <stddef.h>
@@ -21,6 +22,23 @@
  * Note that self->ob_item may change, and even if newsize is less
  * than ob_size on entry.
  */
+#ifdef _SYMBEX_VARSIZE
+/* In the instrumented build, the slots of a list past its size are either
+ * NULL or own a reference, and the list releases them up to its allocated
+ * size.  A list with a symbolic size (see Sym_MakeConcolicList) owns its
+ * items past the size on the paths where the size is smaller, so they are
+ * released on every path.  list_resize() keeps the invariant: it clears the
+ * slots vacated by a shrink, whose items were moved out or released by the
+ * caller, and the slots added by a reallocation.
+ */
+static void
+list_clear_slots(PyObject **items, Py_ssize_t start, Py_ssize_t end)
+{
+    if (start < end)
+        memset(&items[start], 0, (end - start) * sizeof(PyObject *));
+}
+#endif
+
 static int
 list_resize(PyListObject *self, Py_ssize_t newsize)
 {
@@ -34,6 +52,10 @@ list_resize(PyListObject *self, Py_ssize_t newsize)
     */
     if (allocated >= newsize && newsize >= (allocated >> 1)) {
         assert(self->ob_item != NULL || newsize == 0);
+#ifdef _SYMBEX_VARSIZE
+        if (self->ob_item != NULL)
+            list_clear_slots(self->ob_item, newsize, Py_SIZE(self));
+#endif
         Py_SIZE(self) = newsize;
         return 0;
     }
@@ -66,6 +88,15 @@ list_resize(PyListObject *self, Py_ssize_t newsize)
         PyErr_NoMemory();
         return -1;
     }
+#ifdef _SYMBEX_VARSIZE
+    /* The list sort sets allocated to -1, with no items */
+    if (allocated < 0)
+        allocated = 0;
+    list_clear_slots(items, newsize,
+                     Py_SIZE(self) < (Py_ssize_t)new_allocated ?
+                     Py_SIZE(self) : (Py_ssize_t)new_allocated);
+    list_clear_slots(items, allocated, new_allocated);
+#endif
     self->ob_item = items;
     Py_SIZE(self) = newsize;
     self->allocated = new_allocated;
@@ -114,6 +145,9 @@ PyList_New(Py_ssize_t size)
 {
     PyListObject *op;
     size_t nbytes;
+#ifdef _SYMBEX_VARSIZE
+    Py_ssize_t sym_size = size;
+#endif
 #ifdef SHOW_ALLOC_COUNT
     static int initialized = 0;
     if (!initialized) {
@@ -126,6 +160,9 @@ PyList_New(Py_ssize_t size)
         PyErr_BadInternalCall();
         return NULL;
     }
+#ifdef _SYMBEX_VARSIZE
+    PREPARE_VARSIZE(size);
+#endif
     /* Check for overflow without an actual overflow,
      *  which can cause compiler to optimise out */
     if ((size_t)size > PY_SIZE_MAX / sizeof(PyObject *))
@@ -158,6 +195,9 @@ PyList_New(Py_ssize_t size)
     }
     Py_SIZE(op) = size;
     op->allocated = size;
+#ifdef _SYMBEX_VARSIZE
+    Py_SIZE(op) = sym_size;
+#endif
     _PyObject_GC_TRACK(op);
     return (PyObject *) op;
 }
@@ -182,7 +222,7 @@ PyList_GetItem(PyObject *op, Py_ssize_t i)
         PyErr_BadInternalCall();
         return NULL;
     }
-    if (i < 0 || i >= Py_SIZE(op)) {
+    if (!_SYMBEX_VALID_INDEX(i, Py_SIZE(op))) {
         if (indexerr == NULL) {
             indexerr = PyString_FromString(
                 "list index out of range");
@@ -206,7 +246,7 @@ PyList_SetItem(register PyObject *op, register Py_ssize_t i,
         PyErr_BadInternalCall();
         return -1;
     }
-    if (i < 0 || i >= Py_SIZE(op)) {
+    if (!_SYMBEX_VALID_INDEX(i, Py_SIZE(op))) {
         Py_XDECREF(newitem);
         PyErr_SetString(PyExc_IndexError,
                         "list assignment index out of range");
@@ -304,7 +344,11 @@ list_dealloc(PyListObject *op)
            There's a simple test case where somehow this reduces
            thrashing when a *very* large list is created and
            immediately deleted. */
+#ifdef _SYMBEX_VARSIZE
+        i = op->allocated;
+#else
         i = Py_SIZE(op);
+#endif
         while (--i >= 0) {
             Py_XDECREF(op->ob_item[i]);
         }
@@ -449,7 +493,7 @@ list_contains(PyListObject *a, PyObject *el)
 static PyObject *
 list_item(PyListObject *a, Py_ssize_t i)
 {
-    if (i < 0 || i >= Py_SIZE(a)) {
+    if (!_SYMBEX_VALID_INDEX(i, Py_SIZE(a))) {
         if (indexerr == NULL) {
             indexerr = PyString_FromString(
                 "list index out of range");
@@ -589,7 +633,11 @@ list_clear(PyListObject *a)
     if (item != NULL) {
         /* Because XDECREF can recursively invoke operations on
            this list, we make it empty first. */
+#ifdef _SYMBEX_VARSIZE
+        i = a->allocated;
+#else
         i = Py_SIZE(a);
+#endif
         Py_SIZE(a) = 0;
         a->ob_item = NULL;
         a->allocated = 0;
@@ -761,7 +809,7 @@ static int
 list_ass_item(PyListObject *a, Py_ssize_t i, PyObject *v)
 {
     PyObject *old_value;
-    if (i < 0 || i >= Py_SIZE(a)) {
+    if (!_SYMBEX_VALID_INDEX(i, Py_SIZE(a))) {
         PyErr_SetString(PyExc_IndexError,
                         "list assignment index out of range");
         return -1;
@@ -940,7 +988,7 @@ listpop(PyListObject *self, PyObject *args)
     }
     if (i < 0)
         i += Py_SIZE(self);
-    if (i < 0 || i >= Py_SIZE(self)) {
+    if (!_SYMBEX_VALID_INDEX(i, Py_SIZE(self))) {
         PyErr_SetString(PyExc_IndexError, "pop index out of range");
         return NULL;
     }
@@ -2192,7 +2240,11 @@ fail:
 
 dsu_fail:
     final_ob_item = self->ob_item;
+#ifdef _SYMBEX_VARSIZE
+    i = self->allocated;
+#else
     i = Py_SIZE(self);
+#endif
     Py_SIZE(self) = saved_ob_size;
     self->ob_item = saved_ob_item;
     self->allocated = saved_allocated;
@@ -2675,6 +2727,10 @@ list_ass_subscript(PyListObject* self, PyObject* item, PyObject* value)
                      sizeof(PyObject *));
             }
 
+#ifdef _SYMBEX_VARSIZE
+            list_clear_slots(self->ob_item, Py_SIZE(self) - slicelength,
+                             Py_SIZE(self));
+#endif
             Py_SIZE(self) -= slicelength;
             list_resize(self, Py_SIZE(self));
 
@@ -5,6 +5,7 @@
 #include "Python.h"
 #include "longintrepr.h"
 #include "structseq.h"
+#include "symbex.h"
 
 #include <float.h>
 #include <ctype.h>
@@ -65,15 +66,27 @@ long_normalize(register PyLongObject *v)
 PyLongObject *
 _PyLong_New(Py_ssize_t size)
 {
+#ifdef _SYMBEX_VARSIZE
+    PyLongObject *result;
+    Py_ssize_t sym_size = size;
+#endif
     if (size > (Py_ssize_t)MAX_LONG_DIGITS) {
         PyErr_SetString(PyExc_OverflowError,
                         "too many digits in integer");
         return NULL;
     }
+#ifdef _SYMBEX_VARSIZE
+    PREPARE_VARSIZE(size);
+    result = PyObject_NEW_VAR(PyLongObject, &PyLong_Type, size);
+    if (result != NULL)
+        Py_SIZE(result) = sym_size;
+    return result;
+#else
     /* coverity[ampersand_in_size] */
     /* XXX(nnorwitz): PyObject_NEW_VAR / _PyObject_VAR_SIZE need to detect
        overflow */
     return PyObject_NEW_VAR(PyLongObject, &PyLong_Type, size);
+#endif
 }
 
 PyObject *
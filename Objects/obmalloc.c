@@ -152,6 +152,13 @@ static int running_on_valgrind = -1;
 #define SMALL_REQUEST_THRESHOLD 256
 #define NB_SMALL_SIZE_CLASSES   (SMALL_REQUEST_THRESHOLD / ALIGNMENT)
 
+/* The symbolic allocation sizes are concretized to these size classes */
+#if defined(_SYMBEX_ALLOC) && \
+    (ALIGNMENT != _SYMBEX_ALLOC_ALIGNMENT || \
+     SMALL_REQUEST_THRESHOLD != _SYMBEX_ALLOC_SMALL)
+#error "The symbolic allocation size classes do not match obmalloc"
+#endif
+
 /*
  * The system's VMM page size can be obtained on most unices with a
  * getpagesize() call or deduced from various header files. To make
@@ -1273,7 +1280,7 @@ void *
 PyObject_Malloc(size_t n)
 {
 #ifdef _SYMBEX_ALLOC
-    s2e_get_example(&n, sizeof(n));
+    PREPARE_ALLOC(n);
 #endif
     return PyMem_MALLOC(n);
 }
@@ -1282,7 +1289,7 @@ void *
 PyObject_Realloc(void *p, size_t n)
 {
 #ifdef _SYMBEX_ALLOC
-    s2e_get_example(&n, sizeof(n));
+    PREPARE_ALLOC(n);
 #endif
     return PyMem_REALLOC(p, n);
 }
@@ -1410,7 +1417,7 @@ void *
 _PyMem_DebugMalloc(size_t nbytes)
 {
 #ifdef _SYMBEX_ALLOC
-    s2e_get_example(&nbytes, sizeof(nbytes));
+    PREPARE_ALLOC(nbytes);
 #endif
     return _PyObject_DebugMallocApi(_PYMALLOC_MEM_ID, nbytes);
 }
@@ -1418,7 +1425,7 @@ void *
 _PyMem_DebugRealloc(void *p, size_t nbytes)
 {
 #ifdef _SYMBEX_ALLOC
-    s2e_get_example(&nbytes, sizeof(nbytes));
+    PREPARE_ALLOC(nbytes);
 #endif
     return _PyObject_DebugReallocApi(_PYMALLOC_MEM_ID, p, nbytes);
 }
@@ -1433,7 +1440,7 @@ void *
 _PyObject_DebugMalloc(size_t nbytes)
 {
 #ifdef _SYMBEX_ALLOC
-    s2e_get_example(&nbytes, sizeof(nbytes));
+    PREPARE_ALLOC(nbytes);
 #endif
     return _PyObject_DebugMallocApi(_PYMALLOC_OBJ_ID, nbytes);
 }
@@ -1441,7 +1448,7 @@ void *
 _PyObject_DebugRealloc(void *p, size_t nbytes)
 {
 #ifdef _SYMBEX_ALLOC
-    s2e_get_example(&nbytes, sizeof(nbytes));
+    PREPARE_ALLOC(nbytes);
 #endif
     return _PyObject_DebugReallocApi(_PYMALLOC_OBJ_ID, p, nbytes);
 }
@@ -1466,7 +1473,7 @@ _PyObject_DebugMallocApi(char id, size_t nbytes)
     size_t total;       /* nbytes + 4*SST */
 
 #ifdef _SYMBEX_ALLOC
-    s2e_get_example(&nbytes, sizeof(nbytes));
+    PREPARE_ALLOC(nbytes);
 #endif
 
     bumpserialno();
@@ -1526,7 +1533,7 @@ _PyObject_DebugReallocApi(char api, void *p, size_t nbytes)
     int i;
 
 #ifdef _SYMBEX_ALLOC
-    s2e_get_example(&nbytes, sizeof(nbytes));
+    PREPARE_ALLOC(nbytes);
 #endif
 
     if (p == NULL)
@@ -9,6 +9,7 @@
 
 #include "Python.h"
 #include "structmember.h"
+#include "symbex.h"
 
 /* Set a key error with the specified argument, wrapping it in a
  * tuple automatically so that tuple keys are not unpacked as the
@@ -30,6 +31,23 @@ set_key_error(PyObject *arg)
 /* Object used as dummy key to fill deleted entries */
 static PyObject *dummy = NULL; /* Initialized by first call to make_new_set() */
 
+#ifdef _SYMBEX_DICT_HASHES
+static void
+set_make_flat(PySetObject *so);
+
+/* Switch the set to flat mode (see set_lookkey_flat() below) the first time
+ * an unknown hash value is used to access it, as dicts do.
+ */
+#define FLATTEN_IF_SYMBOLIC(so, hash) \
+    do { \
+        if (_SYMBEX_RT(_SYMBEX_RT_CONST_HASHES | _SYMBEX_RT_SYM_HASHES) && \
+            !(so)->flat && !_SYMBEX_HASH_IS_KNOWN(hash)) \
+            set_make_flat(so); \
+    } while(0)
+#else
+#define FLATTEN_IF_SYMBOLIC(so, hash)
+#endif
+
 #ifdef Py_REF_DEBUG
 PyObject *
 _PySet_Dummy(void)
@@ -203,6 +221,62 @@ set_lookkey_string(PySetObject *so, PyObject *key, register long hash)
     return 0;
 }
 
+#ifdef _SYMBEX_DICT_HASHES
+/*
+ * Lookup function used by sets in flat mode, the counterpart of
+ * lookdict_flat() in Objects/dictobject.c.  The entries are packed at the
+ * front of the table, in insertion order:  table[0 .. fill-1] holds active
+ * and dummy entries, and table[fill .. mask] is unused.  Keys are found by
+ * a linear scan, which skips an entry on its hash only when both hashes are
+ * known.  A miss returns the first unused slot, so set_insert_key()
+ * appends.
+ */
+static setentry *
+set_lookkey_flat(PySetObject *so, PyObject *key, long hash)
+{
+    setentry *table = so->table;
+    setentry *end = table + so->fill;
+    register setentry *entry;
+    register int cmp;
+    int known_hash = _SYMBEX_HASH_IS_KNOWN(hash);
+    PyObject *startkey;
+
+    /* Identity checks are on concrete pointers, so do them all first */
+    for (entry = table; entry < end; entry++) {
+        if (entry->key == key)
+            return entry;
+    }
+
+    for (entry = table; entry < end; entry++) {
+        if (entry->key == dummy)
+            continue;
+        if (known_hash && _SYMBEX_HASH_IS_KNOWN(entry->hash) &&
+            entry->hash != hash)
+            continue;
+        if (PyString_CheckExact(key) && PyString_CheckExact(entry->key)) {
+            if (_PyString_Eq(entry->key, key))
+                return entry;
+            continue;
+        }
+        startkey = entry->key;
+        Py_INCREF(startkey);
+        cmp = PyObject_RichCompareBool(startkey, key, Py_EQ);
+        Py_DECREF(startkey);
+        if (cmp < 0)
+            return NULL;
+        if (table != so->table || entry->key != startkey ||
+            end != table + so->fill) {
+            /* The compare mutated the set:  start over. */
+            return set_lookkey_flat(so, key, hash);
+        }
+        if (cmp > 0)
+            return entry;
+    }
+    assert(so->fill <= so->mask);
+    return end;
+}
+#endif /* _SYMBEX_DICT_HASHES */
+
 /*
 Internal routine to insert a new key into the table.
 Used by the public insert routine.
@@ -215,6 +289,7 @@ set_insert_key(register PySetObject *so, PyObject *key, long hash)
     typedef setentry *(*lookupfunc)(PySetObject *, PyObject *, long);
 
     assert(so->lookup != NULL);
+    FLATTEN_IF_SYMBOLIC(so, hash);
     entry = so->lookup(so, key, hash);
     if (entry == NULL)
         return -1;
@@ -266,6 +341,58 @@ set_insert_clean(register PySetObject *so, PyObject *key, long hash)
     so->used++;
 }
 
+#ifdef _SYMBEX_DICT_HASHES
+/*
+Flat-mode counterpart of set_insert_clean():  the table is packed, so the
+key is simply appended after the last entry.
+*/
+static void
+set_insert_flat_clean(register PySetObject *so, PyObject *key, long hash)
+{
+    register setentry *entry = &so->table[so->fill];
+
+    assert(entry->key == NULL);
+    so->fill++;
+    entry->key = key;
+    entry->hash = hash;
+    so->used++;
+}
+
+/*
+Switch a set to flat mode, in place, like dict_make_flat():  active entries
+are moved to the front of the table, keeping their relative order, and
+dummies are dropped.  This never allocates, so it can't fail.
+*/
+static void
+set_make_flat(PySetObject *so)
+{
+    setentry *table = so->table;
+    Py_ssize_t i, j;
+
+    assert(!so->flat);
+    for (i = 0, j = 0; i <= so->mask; i++) {
+        if (table[i].key == NULL)
+            continue;
+        if (table[i].key == dummy) {
+            table[i].key = NULL;
+            table[i].hash = 0;
+            Py_DECREF(dummy);
+            continue;
+        }
+        if (i != j) {
+            table[j] = table[i];
+            table[i].key = NULL;
+            table[i].hash = 0;
+        }
+        j++;
+    }
+    assert(j == so->used);
+    so->fill = j;
+    so->flat = 1;
+    so->lookup = set_lookkey_flat;
+}
+#endif /* _SYMBEX_DICT_HASHES */
+
 /*
 Restructure the table by allocating a new table and reinserting all
 keys again.  When entries have been deleted, the new table may
@@ -347,6 +474,11 @@ set_table_resize(PySetObject *so, Py_ssize_t minused)
         } else {
             /* ACTIVE */
             --i;
+#ifdef _SYMBEX_DICT_HASHES
+            if (so->flat)
+                set_insert_flat_clean(so, entry->key, entry->hash);
+            else
+#endif
             set_insert_clean(so, entry->key, entry->hash);
         }
     }
@@ -409,6 +541,7 @@ set_discard_entry(PySetObject *so, setentry *oldentry)
 {       register setentry *entry;
     PyObject *old_key;
 
+    FLATTEN_IF_SYMBOLIC(so, oldentry->hash);
     entry = (so->lookup)(so, oldentry->key, oldentry->hash);
     if (entry == NULL)
         return -1;
@@ -425,7 +558,11 @@ set_discard_entry(PySetObject *so, setentry *oldentry)
 static int
 set_discard_key(PySetObject *so, PyObject *key)
 {
+#ifdef _SYMBEX_DICT_HASHES
+    long hash;
+#else
     register long hash;
+#endif
     register setentry *entry;
     PyObject *old_key;
 
@@ -436,6 +573,7 @@ set_discard_key(PySetObject *so, PyObject *key)
         if (hash == -1)
             return -1;
     }
+    FLATTEN_IF_SYMBOLIC(so, hash);
     entry = (so->lookup)(so, key, hash);
     if (entry == NULL)
         return -1;
@@ -697,6 +835,7 @@ set_contains_key(PySetObject *so, PyObject *key)
         if (hash == -1)
             return -1;
     }
+    FLATTEN_IF_SYMBOLIC(so, hash);
     entry = (so->lookup)(so, key, hash);
     if (entry == NULL)
         return -1;
@@ -710,6 +849,7 @@ set_contains_entry(PySetObject *so, setentry *entry)
     PyObject *key;
     setentry *lu_entry;
 
+    FLATTEN_IF_SYMBOLIC(so, entry->hash);
     lu_entry = (so->lookup)(so, entry->key, entry->hash);
     if (lu_entry == NULL)
         return -1;
@@ -781,6 +921,9 @@ frozenset_hash(PyObject *self)
     long h, hash = 1927868237L;
     setentry *entry;
     Py_ssize_t pos = 0;
+#ifdef _SYMBEX_HASHES
+    int neutral = 0;
+#endif
 
     if (so->hash != -1)
         return so->hash;
@@ -793,11 +936,19 @@ frozenset_hash(PyObject *self)
            hashes so that many distinct combinations collapse to only
            a handful of distinct hash values. */
         h = entry->hash;
+#ifdef _SYMBEX_HASHES
+        if (_SYMBEX_IS_NEUTRAL_ITEM_HASH(h))
+            neutral = 1;
+#endif
         hash ^= (h ^ (h << 16) ^ 89869747L)  * 3644798167u;
     }
     hash = hash * 69069L + 907133923L;
     if (hash == -1)
         hash = 590923713L;
+#ifdef _SYMBEX_HASHES
+    if (neutral)
+        hash = _SYMBEX_HASH_VALUE;
+#endif
     so->hash = hash;
     return hash;
 }
@@ -809,6 +960,9 @@ typedef struct {
     PySetObject *si_set; /* Set to NULL when iterator is exhausted */
     Py_ssize_t si_used;
     Py_ssize_t si_pos;
+#ifdef _SYMBEX_DICT_HASHES
+    int si_flat;
+#endif
     Py_ssize_t len;
 } setiterobject;
 
@@ -853,7 +1007,11 @@ static PyObject *setiter_iternext(setiterobject *si)
         return NULL;
     assert (PyAnySet_Check(so));
 
+#ifdef _SYMBEX_DICT_HASHES
+    if (si->si_used != so->used || si->si_flat != so->flat) {
+#else
     if (si->si_used != so->used) {
+#endif
         PyErr_SetString(PyExc_RuntimeError,
                         "Set changed size during iteration");
         si->si_used = -1; /* Make this state sticky */
@@ -923,6 +1081,9 @@ set_iter(PySetObject *so)
     si->si_set = so;
     si->si_used = so->used;
     si->si_pos = 0;
+#ifdef _SYMBEX_DICT_HASHES
+    si->si_flat = so->flat;
+#endif
     si->len = so->used;
     _PyObject_GC_TRACK(si);
     return (PyObject *)si;
@@ -1027,6 +1188,9 @@ make_new_set(PyTypeObject *type, PyObject *iterable)
     }
 
     so->lookup = set_lookkey_string;
+#ifdef _SYMBEX_DICT_HASHES
+    so->flat = 0;
+#endif
     so->weakreflist = NULL;
 
     if (iterable != NULL) {
@@ -1132,6 +1296,9 @@ set_swap_bodies(PySetObject *a, PySetObject *b)
     b->table = u;
 
     f = a->lookup;   a->lookup = b->lookup;      b->lookup = f;
+#ifdef _SYMBEX_DICT_HASHES
+    t = a->flat;     a->flat   = b->flat;        b->flat  = t;
+#endif
 
     if (a->table == a->smalltable || b->table == b->smalltable) {
         memcpy(tab, a->smalltable, sizeof(tab));
@@ -1810,6 +1977,11 @@ set_richcompare(PySetObject *v, PyObject *w, int op)
             Py_RETURN_FALSE;
         if (v->hash != -1  &&
             ((PySetObject *)w)->hash != -1 &&
+#ifdef _SYMBEX_HASHES
+            /* An unknown hash may differ from the one of an equal set */
+            _SYMBEX_HASH_IS_KNOWN(v->hash) &&
+            _SYMBEX_HASH_IS_KNOWN(((PySetObject *)w)->hash) &&
+#endif
             v->hash != ((PySetObject *)w)->hash)
             Py_RETURN_FALSE;
         return set_issubset(v, w);
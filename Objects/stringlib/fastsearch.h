@@ -33,6 +33,55 @@
 #define STRINGLIB_BLOOM(mask, ch)     \
     ((mask &  (1UL << ((ch) & (STRINGLIB_BLOOM_WIDTH -1)))))
 
+/* symbolic search: when the string or the pattern is symbolic, each skip
+   decision above forks, and so does each character of a candidate match.
+   this variant compares every window in full, with no branches on its
+   contents, so there is a single branch per position in the string. */
+
+Py_LOCAL_INLINE(int)
+symbex_window_match(const STRINGLIB_CHAR* s, const STRINGLIB_CHAR* p,
+                    Py_ssize_t m)
+{
+    int match = 1;
+    Py_ssize_t j;
+
+    for (j = 0; j < m; j++)
+        match &= (s[j] == p[j]);
+    return match;
+}
+
+Py_LOCAL_INLINE(Py_ssize_t)
+symbex_fastsearch(const STRINGLIB_CHAR* s, Py_ssize_t n,
+                  const STRINGLIB_CHAR* p, Py_ssize_t m,
+                  Py_ssize_t maxcount, int mode)
+{
+    Py_ssize_t i, count = 0;
+    Py_ssize_t w = n - m;
+
+    if (mode == FAST_RSEARCH) {
+        for (i = w; i >= 0; i--)
+            if (symbex_window_match(s + i, p, m))
+                return i;
+        return -1;
+    }
+
+    for (i = 0; i <= w; i++) {
+        if (symbex_window_match(s + i, p, m)) {
+            if (mode != FAST_COUNT)
+                return i;
+            count++;
+            if (count == maxcount)
+                return maxcount;
+            /* matches do not overlap */
+            i = i + m - 1;
+        }
+    }
+
+    if (mode != FAST_COUNT)
+        return -1;
+    return count;
+}
+
 Py_LOCAL_INLINE(Py_ssize_t)
 fastsearch(const STRINGLIB_CHAR* s, Py_ssize_t n,
            const STRINGLIB_CHAR* p, Py_ssize_t m,
@@ -47,6 +96,9 @@ fastsearch(const STRINGLIB_CHAR* s, Py_ssize_t n,
     if (w < 0 || (mode == FAST_COUNT && maxcount == 0))
         return -1;
 
+    if (m > 0 && _SYMBEX_SYMBOLIC_PAIR(s, n, p, m, sizeof(STRINGLIB_CHAR)))
+        return symbex_fastsearch(s, n, p, m, maxcount, mode);
+
     /* look for special cases */
     if (m <= 1) {
         if (m <= 0)
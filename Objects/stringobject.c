@@ -62,14 +62,15 @@ PyString_FromStringAndSize(const char *str, Py_ssize_t size)
     int can_intern = !IS_SYMBOLIC_STR_SIZE(str, size);
 #ifdef _SYMBEX_VARSIZE
     Py_ssize_t sym_size = size;
-    s2e_get_example(&size, sizeof(size));
-    s2e_assume(sym_size >= 0 && sym_size <= size);
 #endif
     if (size < 0) {
         PyErr_SetString(PyExc_SystemError,
             "Negative size passed to PyString_FromStringAndSize");
         return NULL;
     }
+#ifdef _SYMBEX_VARSIZE
+    PREPARE_VARSIZE(size);
+#endif
     if (can_intern && size == 0 && (op = nullstring) != NULL) {
 #ifdef COUNT_ALLOCS
         null_strings++;
@@ -99,12 +100,25 @@ PyString_FromStringAndSize(const char *str, Py_ssize_t size)
     PyObject_INIT_VAR(op, &PyString_Type, size);
     op->ob_shash = -1;
     op->ob_sstate = SSTATE_NOT_INTERNED;
-    if (str != NULL)
-        Py_MEMCPY(op->ob_sval, str, size);
-    op->ob_sval[size] = '\0';
 #ifdef _SYMBEX_VARSIZE
-    op->ob_size = sym_size;
+    if (IS_SYMBOLIC_SIZE(sym_size) && !IS_SYMBOLIC_SIZE(size)) {
+        /* The buffer spans the size class of the symbolic size.  Zero it
+           whole, so that the string is terminated whatever its size,
+           without a store at a symbolic index.  The copy still stops at
+           the symbolic size, and forks once per length that the path
+           allows: the lengths of a class only share the allocation. */
+        memset(op->ob_sval, 0, size + 1);
+        op->ob_size = sym_size;
+        if (str != NULL)
+            Py_MEMCPY(op->ob_sval, str, sym_size);
+    }
+    else
 #endif
+    {
+        if (str != NULL)
+            Py_MEMCPY(op->ob_sval, str, Py_SIZE(op));
+        op->ob_sval[Py_SIZE(op)] = '\0';
+    }
     /* share short strings */
     if (!can_intern)
         return (PyObject *) op;
@@ -129,6 +143,7 @@ PyString_FromString(const char *str)
 {
 #ifdef _SYMBEX_VARSIZE
     size_t size;
+    Py_ssize_t sym_size;
 #else
     register size_t size;
 #endif
@@ -138,9 +153,8 @@ PyString_FromString(const char *str)
     assert(str != NULL);
     size = strlen(str);
 #ifdef _SYMBEX_VARSIZE
-    Py_ssize_t sym_size = size;
-    s2e_get_example(&size, sizeof(size));
-    s2e_assume(sym_size >= 0 && sym_size <= size);
+    sym_size = size;
+    PREPARE_VARSIZE(size);
 #endif
     if (size > PY_SSIZE_T_MAX - PyStringObject_SIZE) {
         PyErr_SetString(PyExc_OverflowError,
@@ -169,10 +183,16 @@ PyString_FromString(const char *str)
     PyObject_INIT_VAR(op, &PyString_Type, size);
     op->ob_shash = -1;
     op->ob_sstate = SSTATE_NOT_INTERNED;
-    Py_MEMCPY(op->ob_sval, str, size+1);
 #ifdef _SYMBEX_VARSIZE
-    op->ob_size = sym_size;
+    if (IS_SYMBOLIC_SIZE(sym_size) && !IS_SYMBOLIC_SIZE(size)) {
+        /* As in PyString_FromStringAndSize() */
+        memset(op->ob_sval, 0, size + 1);
+        op->ob_size = sym_size;
+        Py_MEMCPY(op->ob_sval, str, sym_size);
+    }
+    else
 #endif
+    Py_MEMCPY(op->ob_sval, str, Py_SIZE(op)+1);
     if (!can_intern)
         return (PyObject *) op;
     /* share short strings */
@@ -1199,9 +1219,8 @@ string_item(PyStringObject *a, register Py_ssize_t i)
         return NULL;
     }
     pchar = a->ob_sval[i];
-#ifdef _SYMBEX_INTERNED_STRING
-    v = PyString_FromStringAndSize(&pchar, 1);
-#else
+    if (_SYMBEX_SKIP_INTERN(&pchar, sizeof(pchar)))
+        return PyString_FromStringAndSize(&pchar, 1);
     v = (PyObject *)characters[pchar & UCHAR_MAX];
     if (v == NULL)
         v = PyString_FromStringAndSize(&pchar, 1);
@@ -1211,16 +1230,46 @@ string_item(PyStringObject *a, register Py_ssize_t i)
 #endif
         Py_INCREF(v);
     }
-#endif
     return v;
 }
 
+/* Branch-free comparisons for symbolic strings: every byte is visited, and
+   only the test of the result by the caller forks. */
+static int
+symbex_string_equal(const char *a, const char *b, Py_ssize_t len)
+{
+    int result = 1;
+    Py_ssize_t i;
+
+    for (i = 0; i < len; ++i) {
+        result &= (a[i] == b[i]);
+    }
+    return result;
+}
+
+/* Returns <0, 0 or >0, like memcmp() followed by the length comparison */
+static int
+symbex_string_compare(const char *a, Py_ssize_t len_a,
+                      const char *b, Py_ssize_t len_b)
+{
+    Py_ssize_t min_len = (len_a < len_b) ? len_a : len_b;
+    Py_ssize_t i;
+    int c = 0;
+
+    for (i = 0; i < min_len; ++i) {
+        c += (c == 0) * (Py_CHARMASK(a[i]) - Py_CHARMASK(b[i]));
+    }
+    c += (c == 0) * ((len_a > len_b) - (len_a < len_b));
+    return c;
+}
+
 static PyObject*
 string_richcompare(PyStringObject *a, PyStringObject *b, int op)
 {
     int c;
     Py_ssize_t len_a, len_b;
     Py_ssize_t min_len;
+    const char *sa, *sb;
     PyObject *result;
 
     /* Make sure both arguments are strings. */
@@ -1238,6 +1287,17 @@ string_richcompare(PyStringObject *a, PyStringObject *b, int op)
             goto out;
         }
     }
+    sa = a->ob_sval;
+    sb = b->ob_sval;
+    if (_SYMBEX_SYMBOLIC_PAIR(sa, Py_SIZE(a), sb, Py_SIZE(b), 1)) {
+        if (op == Py_EQ) {
+            result = _PyString_Eq((PyObject *)a, (PyObject *)b) ?
+                Py_True : Py_False;
+            goto out;
+        }
+        c = symbex_string_compare(sa, Py_SIZE(a), sb, Py_SIZE(b));
+        goto compared;
+    }
     if (op == Py_EQ) {
         /* Supporting Py_NE here as well does not save
            much time, since Py_NE is rarely used.  */
@@ -1260,6 +1320,7 @@ string_richcompare(PyStringObject *a, PyStringObject *b, int op)
         c = 0;
     if (c == 0)
         c = (len_a < len_b) ? -1 : (len_a > len_b) ? 1 : 0;
+  compared:
     switch (op) {
     case Py_LT: c = c <  0; break;
     case Py_LE: c = c <= 0; break;
@@ -1282,46 +1343,20 @@ _PyString_Eq(PyObject *o1, PyObject *o2)
 {
     PyStringObject *a = (PyStringObject*) o1;
     PyStringObject *b = (PyStringObject*) o2;
-#ifdef _SYMBEX_SHORT_CIRCUITED
-	int result = 1;
-	Py_ssize_t i;
-
-	if (Py_SIZE(a) != Py_SIZE(b)) {
-		return 0;
-	}
-
-	for (i = 0; i < Py_SIZE(a); ++i) {
-		result &= (a->ob_sval[i] == b->ob_sval[i]);
-	}
+    const char *sa = a->ob_sval;
+    const char *sb = b->ob_sval;
 
-	return result;
-#else
+    if (_SYMBEX_SYMBOLIC_PAIR(sa, Py_SIZE(a), sb, Py_SIZE(b), 1)) {
+        if (Py_SIZE(a) != Py_SIZE(b)) {
+            return 0;
+        }
+        return symbex_string_equal(sa, sb, Py_SIZE(a));
+    }
     return Py_SIZE(a) == Py_SIZE(b)
       && *a->ob_sval == *b->ob_sval
       && memcmp(a->ob_sval, b->ob_sval, Py_SIZE(a)) == 0;
-#endif
 }
 
-#ifdef _SYMBEX_HASHES
-
-static long
-string_hash(PyStringObject *a)
-{
-#ifdef Py_DEBUG
-  assert(_Py_HashSecret_Initialized);
-#endif
-  if (a->ob_shash != -1)
-      return a->ob_shash;
-#if defined(_SYMBEX_GLOBAL_HASHES) || defined(_SYMBEX_CONST_HASHES)
-  a->ob_shash = _SYMBEX_HASH_VALUE;
-#else
-  a->ob_shash = Py_SIZE(a);
-#endif
-  return a->ob_shash;
-}
-
-#else
-
 static long
 string_hash(PyStringObject *a)
 {
@@ -1334,6 +1369,12 @@ string_hash(PyStringObject *a)
 #endif
     if (a->ob_shash != -1)
         return a->ob_shash;
+#ifdef _SYMBEX_HASHES
+    if (_SYMBEX_NEUTRAL_HASH(a->ob_sval, a->ob_size)) {
+        a->ob_shash = _SYMBEX_HASH_VALUE;
+        return a->ob_shash;
+    }
+#endif
     len = Py_SIZE(a);
     /*
       We make the hash of the empty string be 0, rather than using
@@ -1356,8 +1397,6 @@ string_hash(PyStringObject *a)
     return x;
 }
 
-#endif /* _SYMBEX_HASHES */
-
 static PyObject*
 string_subscript(PyStringObject* self, PyObject* item)
 {
@@ -2,6 +2,7 @@
 /* Tuple object implementation */
 
 #include "Python.h"
+#include "symbex.h"
 
 /* Speed optimization to avoid frequent malloc/free of small tuples */
 #ifndef PyTuple_MAXSAVESIZE
@@ -46,14 +47,20 @@ show_track(void)
 
 
 PyObject *
-PyTuple_New(register Py_ssize_t size)
+PyTuple_New(Py_ssize_t size)
 {
     register PyTupleObject *op;
     Py_ssize_t i;
+#ifdef _SYMBEX_VARSIZE
+    Py_ssize_t sym_size = size;
+#endif
     if (size < 0) {
         PyErr_BadInternalCall();
         return NULL;
     }
+#ifdef _SYMBEX_VARSIZE
+    PREPARE_VARSIZE(size);
+#endif
 #if PyTuple_MAXSAVESIZE > 0
     if (size == 0 && free_list[0]) {
         op = free_list[0];
@@ -102,6 +109,12 @@ PyTuple_New(register Py_ssize_t size)
 #endif
 #ifdef SHOW_TRACK_COUNT
     count_tracked++;
+#endif
+#ifdef _SYMBEX_VARSIZE
+    /* The items are allocated, and owned, up to the size class */
+    if (IS_SYMBOLIC_SIZE(sym_size) && !IS_SYMBOLIC_SIZE(size))
+        _PySymbex_SetCapacity((PyObject *)op, size);
+    Py_SIZE(op) = sym_size;
 #endif
     _PyObject_GC_TRACK(op);
     return (PyObject *) op;
@@ -125,7 +138,7 @@ PyTuple_GetItem(register PyObject *op, register Py_ssize_t i)
         PyErr_BadInternalCall();
         return NULL;
     }
-    if (i < 0 || i >= Py_SIZE(op)) {
+    if (!_SYMBEX_VALID_INDEX(i, Py_SIZE(op))) {
         PyErr_SetString(PyExc_IndexError, "tuple index out of range");
         return NULL;
     }
@@ -142,7 +155,7 @@ PyTuple_SetItem(register PyObject *op, register Py_ssize_t i, PyObject *newitem)
         PyErr_BadInternalCall();
         return -1;
     }
-    if (i < 0 || i >= Py_SIZE(op)) {
+    if (!_SYMBEX_VALID_INDEX(i, Py_SIZE(op))) {
         Py_XDECREF(newitem);
         PyErr_SetString(PyExc_IndexError,
                         "tuple assignment index out of range");
@@ -211,9 +224,24 @@ static void
 tupledealloc(register PyTupleObject *op)
 {
     register Py_ssize_t i;
+#ifdef _SYMBEX_VARSIZE
+    Py_ssize_t len = Py_SIZE(op);
+#else
     register Py_ssize_t len =  Py_SIZE(op);
+#endif
     PyObject_GC_UnTrack(op);
     Py_TRASHCAN_SAFE_BEGIN(op)
+#ifdef _SYMBEX_VARSIZE
+    /* A tuple with a symbolic size owns its items up to its capacity, and
+       skips the free lists, which are indexed by the size */
+    if (IS_SYMBOLIC_SIZE(len)) {
+        i = _PySymbex_TakeCapacity((PyObject *)op, len);
+        while (--i >= 0)
+            Py_XDECREF(op->ob_item[i]);
+        Py_TYPE(op)->tp_free((PyObject *)op);
+        goto done;
+    }
+#endif
     if (len > 0) {
         i = len;
         while (--i >= 0)
@@ -339,7 +367,13 @@ Done:
 static long
 tuplehash(PyTupleObject *v)
 {
+#ifdef _SYMBEX_HASHES
+    register long x;
+    long y;
+    int neutral = 0;
+#else
     register long x, y;
+#endif
     register Py_ssize_t len = Py_SIZE(v);
     register PyObject **p;
     long mult = 1000003L;
@@ -349,10 +383,19 @@ tuplehash(PyTupleObject *v)
         y = PyObject_Hash(*p++);
         if (y == -1)
             return -1;
+#ifdef _SYMBEX_HASHES
+        /* The other items are still hashed, for their errors */
+        if (_SYMBEX_IS_NEUTRAL_ITEM_HASH(y))
+            neutral = 1;
+#endif
         x = (x ^ y) * mult;
         /* the cast might truncate len; that doesn't change hash stability */
         mult += (long)(82520L + len + len);
     }
+#ifdef _SYMBEX_HASHES
+    if (neutral)
+        return _SYMBEX_HASH_VALUE;
+#endif
     x += 97531L;
     if (x == -1)
         x = -2;
@@ -380,7 +423,7 @@ tuplecontains(PyTupleObject *a, PyObject *el)
 static PyObject *
 tupleitem(register PyTupleObject *a, register Py_ssize_t i)
 {
-    if (i < 0 || i >= Py_SIZE(a)) {
+    if (!_SYMBEX_VALID_INDEX(i, Py_SIZE(a))) {
         PyErr_SetString(PyExc_IndexError, "tuple index out of range");
         return NULL;
     }
@@ -860,6 +903,14 @@ _PyTuple_Resize(PyObject **pv, Py_ssize_t newsize)
         return -1;
     }
     oldsize = Py_SIZE(v);
+#ifdef _SYMBEX_VARSIZE
+    /* Resize from the capacity of a symbolic size, so that the items past
+       the size are released or kept */
+    if (IS_SYMBOLIC_SIZE(oldsize)) {
+        oldsize = _PySymbex_TakeCapacity((PyObject *)v, oldsize);
+        Py_SIZE(v) = oldsize;
+    }
+#endif
     if (oldsize == newsize)
         return 0;
 
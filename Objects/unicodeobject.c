@@ -93,20 +93,16 @@ OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 extern "C" {
 #endif
 
-#ifndef _SYMBEX_INTERNED
 /* Free list for Unicode objects */
 static PyUnicodeObject *free_list;
 static int numfree;
-#endif /* _SYMBEX_INTERNED */
 
 /* The empty Unicode object is shared to improve performance. */
 static PyUnicodeObject *unicode_empty;
 
-#ifndef _SYMBEX_INTERNED
 /* Single character Unicode strings in the Latin-1 range are being
    shared as well. */
 static PyUnicodeObject *unicode_latin1[256];
-#endif /* _SYMBEX_INTERNED */
 
 /* Default encoding to use and assume when NULL is passed as encoding
    parameter; it is initialized by _PyUnicode_Init().
@@ -262,14 +258,10 @@ int unicode_resize(register PyUnicodeObject *unicode,
        objects) in-place is not allowed. Use PyUnicode_Resize()
        instead ! */
 
-#ifndef _SYMBEX_INTERNED
     if (unicode == unicode_empty ||
         (unicode->length == 1 &&
          unicode->str[0] < 256U &&
          unicode_latin1[unicode->str[0]] == unicode)) {
-#else
-    if (unicode == unicode_empty) {
-#endif
         PyErr_SetString(PyExc_SystemError,
                         "can't resize shared unicode objects");
         return -1;
@@ -313,28 +305,25 @@ static
 PyUnicodeObject *_PyUnicode_New(Py_ssize_t length)
 {
     register PyUnicodeObject *unicode;
+    int can_intern = !_SYMBEX_SKIP_INTERN(&length, sizeof(length));
 #ifdef _SYMBEX_VARSIZE
     Py_ssize_t sym_length = length;
-    s2e_get_example(&length, sizeof(length));
-    s2e_assume(sym_length <= length);
+    PREPARE_VARSIZE(length);
 #endif
 
-#ifndef _SYMBEX_INTERNED
     /* Optimization for empty strings */
-    if (length == 0 && unicode_empty != NULL) {
+    if (can_intern && length == 0 && unicode_empty != NULL) {
         Py_INCREF(unicode_empty);
         return unicode_empty;
     }
-#endif
 
     /* Ensure we won't overflow the size. */
     if (length > ((PY_SSIZE_T_MAX / sizeof(Py_UNICODE)) - 1)) {
         return (PyUnicodeObject *)PyErr_NoMemory();
     }
 
-#ifndef _SYMBEX_INTERNED
     /* Unicode freelist & memory allocation */
-    if (free_list) {
+    if (can_intern && free_list) {
         unicode = free_list;
         free_list = *(PyUnicodeObject **)unicode;
         numfree--;
@@ -353,9 +342,6 @@ PyUnicodeObject *_PyUnicode_New(Py_ssize_t length)
         }
         PyObject_INIT(unicode, &PyUnicode_Type);
     } else {
-#else
-    {
-#endif
         size_t new_size;
         unicode = PyObject_New(PyUnicodeObject, &PyUnicode_Type);
         if (unicode == NULL)
@@ -376,12 +362,20 @@ PyUnicodeObject *_PyUnicode_New(Py_ssize_t length)
      * that case.
      */
     unicode->str[0] = 0;
-    unicode->str[length] = 0;
 #ifdef _SYMBEX_VARSIZE
-    unicode->length = sym_length;
-#else
-    unicode->length = length;
+    if (IS_SYMBOLIC_SIZE(sym_length) && !IS_SYMBOLIC_SIZE(length)) {
+        /* The buffer spans the size class of the symbolic length.  Zero it
+           whole, so that the string is terminated whatever its length,
+           without a store at a symbolic index. */
+        memset(unicode->str, 0, sizeof(Py_UNICODE) * ((size_t)length + 1));
+        unicode->length = sym_length;
+    }
+    else
 #endif
+    {
+        unicode->length = length;
+        unicode->str[length] = 0;
+    }
     unicode->hash = -1;
     unicode->defenc = NULL;
     return unicode;
@@ -397,8 +391,8 @@ PyUnicodeObject *_PyUnicode_New(Py_ssize_t length)
 static
 void unicode_dealloc(register PyUnicodeObject *unicode)
 {
-#ifndef _SYMBEX_INTERNED
-    if (PyUnicode_CheckExact(unicode) &&
+    if (!_SYMBEX_SKIP_INTERN(&unicode->length, sizeof(unicode->length)) &&
+        PyUnicode_CheckExact(unicode) &&
         numfree < PyUnicode_MAXFREELIST) {
         /* Keep-Alive optimization */
         if (unicode->length >= KEEPALIVE_SIZE_LIMIT) {
@@ -415,9 +409,6 @@ void unicode_dealloc(register PyUnicodeObject *unicode)
         numfree++;
     }
     else {
-#else
-    {
-#endif
         PyObject_DEL(unicode->str);
         Py_XDECREF(unicode->defenc);
         Py_TYPE(unicode)->tp_free((PyObject *)unicode);
@@ -475,15 +466,15 @@ PyObject *PyUnicode_FromUnicode(const Py_UNICODE *u,
     if (u != NULL) {
 
         /* Optimization for empty strings */
-        if (size == 0 && unicode_empty != NULL) {
+        if (!_SYMBEX_SKIP_INTERN(&size, sizeof(size)) &&
+            size == 0 && unicode_empty != NULL) {
             Py_INCREF(unicode_empty);
             return (PyObject *)unicode_empty;
         }
 
-#ifndef _SYMBEX_INTERNED
         /* Single character Unicode objects in the Latin-1 range are
            shared when using this constructor */
-        if (size == 1 && *u < 256) {
+        if (size == 1 && !_SYMBEX_SKIP_INTERN(u, sizeof(*u)) && *u < 256) {
             unicode = unicode_latin1[*u];
             if (!unicode) {
                 unicode = _PyUnicode_New(1);
@@ -495,7 +486,6 @@ PyObject *PyUnicode_FromUnicode(const Py_UNICODE *u,
             Py_INCREF(unicode);
             return (PyObject *)unicode;
         }
-#endif /* _SYMBEX_INTERNED */
     }
 
     unicode = _PyUnicode_New(size);
@@ -526,15 +516,16 @@ PyObject *PyUnicode_FromStringAndSize(const char *u, Py_ssize_t size)
     if (u != NULL) {
 
         /* Optimization for empty strings */
-        if (size == 0 && unicode_empty != NULL) {
+        if (!_SYMBEX_SKIP_INTERN(&size, sizeof(size)) &&
+            size == 0 && unicode_empty != NULL) {
             Py_INCREF(unicode_empty);
             return (PyObject *)unicode_empty;
         }
 
-#ifndef _SYMBEX_INTERNED
         /* Single characters are shared when using this constructor.
            Restrict to ASCII, since the input must be UTF-8. */
-        if (size == 1 && Py_CHARMASK(*u) < 128) {
+        if (size == 1 && !_SYMBEX_SKIP_INTERN(u, 1) &&
+            Py_CHARMASK(*u) < 128) {
             unicode = unicode_latin1[Py_CHARMASK(*u)];
             if (!unicode) {
                 unicode = _PyUnicode_New(1);
@@ -546,7 +537,6 @@ PyObject *PyUnicode_FromStringAndSize(const char *u, Py_ssize_t size)
             Py_INCREF(unicode);
             return (PyObject *)unicode;
         }
-#endif /* _SYMBEX_INTERNED */
 
         return PyUnicode_DecodeUTF8(u, size, NULL);
     }
@@ -6114,10 +6104,27 @@ unicode_compare(PyUnicodeObject *str1, PyUnicodeObject *str2)
 
 #else
 
+/* Branch-free comparison for symbolic strings: every character is visited,
+   and only the test of the result by the caller forks. */
+static int
+symbex_unicode_compare(const Py_UNICODE *s1, Py_ssize_t len1,
+                       const Py_UNICODE *s2, Py_ssize_t len2)
+{
+    Py_ssize_t min_len = (len1 < len2) ? len1 : len2;
+    Py_ssize_t i;
+    int c = 0;
+
+    for (i = 0; i < min_len; ++i) {
+        c += (c == 0) * ((s1[i] > s2[i]) - (s1[i] < s2[i]));
+    }
+    c += (c == 0) * ((len1 > len2) - (len1 < len2));
+    return c;
+}
+
 static int
 unicode_compare(PyUnicodeObject *str1, PyUnicodeObject *str2)
 {
-    register Py_ssize_t len1, len2;
+    Py_ssize_t len1, len2;
 
     Py_UNICODE *s1 = str1->str;
     Py_UNICODE *s2 = str2->str;
@@ -6125,6 +6132,15 @@ unicode_compare(PyUnicodeObject *str1, PyUnicodeObject *str2)
     len1 = str1->length;
     len2 = str2->length;
 
+    if (_SYMBEX_RT(_SYMBEX_RT_NOFASTPATH)) {
+        if (_SYMBEX_SYMBOLIC_PAIR(s1, len1, s2, len2, sizeof(Py_UNICODE)))
+            return symbex_unicode_compare(s1, len1, s2, len2);
+        /* Equal concrete strings, as in most dict lookups, take a single
+           vectorized pass */
+        if (len1 == len2 && memcmp(s1, s2, len1 * sizeof(Py_UNICODE)) == 0)
+            return 0;
+    }
+
     while (len1 > 0 && len2 > 0) {
         Py_UNICODE c1, c2;
 
@@ -6556,26 +6572,6 @@ unicode_getitem(PyUnicodeObject *self, Py_ssize_t index)
     return (PyObject*) PyUnicode_FromUnicode(&self->str[index], 1);
 }
 
-#ifdef _SYMBEX_HASHES
-
-static long
-unicode_hash(PyUnicodeObject *self)
-{
-#ifdef Py_DEBUG
-    assert(_Py_HashSecret_Initialized);
-#endif
-    if (self->hash != -1)
-    	return self->hash;
-#if defined(_SYMBEX_GLOBAL_HASHES) || defined(_SYMBEX_CONST_HASHES)
-    self->hash = _SYMBEX_HASH_VALUE;
-#else
-    self->hash = PyUnicode_GET_SIZE(self);
-#endif
-    return self->hash;
-}
-
-#else
-
 static long
 unicode_hash(PyUnicodeObject *self)
 {
@@ -6594,6 +6590,15 @@ unicode_hash(PyUnicodeObject *self)
 #endif
     if (self->hash != -1)
         return self->hash;
+#ifdef _SYMBEX_HASHES
+    {
+        Py_ssize_t size = self->length * sizeof(Py_UNICODE);
+        if (_SYMBEX_NEUTRAL_HASH(self->str, size)) {
+            self->hash = _SYMBEX_HASH_VALUE;
+            return self->hash;
+        }
+    }
+#endif
     len = PyUnicode_GET_SIZE(self);
     /*
       We make the hash of the empty string be 0, rather than using
@@ -6616,8 +6621,6 @@ unicode_hash(PyUnicodeObject *self)
     return x;
 }
 
-#endif /* _SYMBEX_HASHES */
-
 PyDoc_STRVAR(index__doc__,
              "S.index(sub [,start [,end]]) -> int\n\
 \n\
@@ -8885,19 +8888,15 @@ void _PyUnicode_Init(void)
     };
 
     /* Init the implementation */
-#ifndef _SYMBEX_INTERNED
     free_list = NULL;
     numfree = 0;
-#endif /* _SYMBEX_INTERNED */
     unicode_empty = _PyUnicode_New(0);
     if (!unicode_empty)
         return;
 
     strcpy(unicode_default_encoding, "ascii");
-#ifndef _SYMBEX_INTERNED
     for (i = 0; i < 256; i++)
         unicode_latin1[i] = NULL;
-#endif /* _SYMBEX_INTERNED */
     if (PyType_Ready(&PyUnicode_Type) < 0)
         Py_FatalError("Can't initialize 'unicode'");
 
@@ -8914,7 +8913,6 @@ void _PyUnicode_Init(void)
 int
 PyUnicode_ClearFreeList(void)
 {
-#ifndef _SYMBEX_INTERNED
     int freelist_size = numfree;
     PyUnicodeObject *u;
 
@@ -8930,9 +8928,6 @@ PyUnicode_ClearFreeList(void)
     free_list = NULL;
     assert(numfree == 0);
     return freelist_size;
-#else
-    return 0;
-#endif /* _SYMBEX_INTERNED */
 }
 
 void
@@ -8943,14 +8938,12 @@ _PyUnicode_Fini(void)
     Py_XDECREF(unicode_empty);
     unicode_empty = NULL;
 
-#ifndef _SYMBEX_INTERNED
     for (i = 0; i < 256; i++) {
         if (unicode_latin1[i]) {
             Py_DECREF(unicode_latin1[i]);
             unicode_latin1[i] = NULL;
         }
     }
-#endif /* _SYMBEX_INTERNED */
     (void)PyUnicode_ClearFreeList();
 }
 
@@ -3276,9 +3276,9 @@ int _PyUnicode_IsWhitespace(register const Py_UNICODE ch)
 #ifdef WANT_WCTYPE_FUNCTIONS
     return iswspace(ch);
 #else
-#ifdef _SYMBEX_SHORT_CIRCUITED
     /* Purposedly not using short-circuited operators to avoid branching */
-    return (ch == 0x0009) |
+    if (_SYMBEX_RT(_SYMBEX_RT_NOFASTPATH))
+        return (ch == 0x0009) |
     	   (ch == 0x000A) |
     	   (ch == 0x000B) |
     	   (ch == 0x000C) |
@@ -3308,7 +3308,6 @@ int _PyUnicode_IsWhitespace(register const Py_UNICODE ch)
     	   (ch == 0x202F) |
     	   (ch == 0x205F) |
     	   (ch == 0x3000);
-#else
     switch (ch) {
     case 0x0009:
     case 0x000A:
@@ -3343,7 +3342,6 @@ int _PyUnicode_IsWhitespace(register const Py_UNICODE ch)
         return 1;
     }
     return 0;
-#endif /* _SYMBEX_SHORT_CIRCUITED */
 #endif
 }
 
@@ -3353,9 +3351,9 @@ int _PyUnicode_IsWhitespace(register const Py_UNICODE ch)
  */
 int _PyUnicode_IsLinebreak(register const Py_UNICODE ch)
 {
-#ifdef _SYMBEX_SHORT_CIRCUITED
 	/* Purposedly not using short-circuited operators to avoid branching */
-	return (ch == 0x000A) |
+	if (_SYMBEX_RT(_SYMBEX_RT_NOFASTPATH))
+	    return (ch == 0x000A) |
 		   (ch == 0x000B) |
 		   (ch == 0x000C) |
 		   (ch == 0x000D) |
@@ -3366,7 +3364,6 @@ int _PyUnicode_IsLinebreak(register const Py_UNICODE ch)
 		   (ch == 0x2028) |
 		   (ch == 0x2029);
 
-#else
     switch (ch) {
     case 0x000A:
     case 0x000B:
@@ -3381,6 +3378,5 @@ int _PyUnicode_IsLinebreak(register const Py_UNICODE ch)
         return 1;
     }
     return 0;
-#endif /* _SYMBEX_SHORT_CIRCUITED */
 }
 
@@ -16,6 +16,7 @@
 #include "eval.h"
 #include "opcode.h"
 #include "structmember.h"
+#include "symbex.h"
 
 #include <ctype.h>
 
@@ -169,6 +170,11 @@ static long dxp[256];
 #endif
 #endif
 
+/* Opcode metadata for the symbolic execution engine */
+#ifdef SYMBEX_INSTRUMENTATION
+#include "symbex_opcodes.h"
+#endif
+
 /* Function call profile */
 #ifdef CALL_PROFILE
 #define PCALL_NUM 11
@@ -805,6 +811,10 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
 
 #ifdef DYNAMIC_EXECUTION_PROFILE
 #define PREDICT(op)             if (0) goto PRED_##op
+#elif defined(_SYMBEX_INSN_TRACE)
+/* The predicted opcodes would skip the instruction trace */
+#define PREDICT(op)             if (tstate->symbex_insn_buffer == NULL && \
+                                    *next_instr == op) goto PRED_##op
 #else
 #define PREDICT(op)             if (*next_instr == op) goto PRED_##op
 #endif
@@ -1069,6 +1079,21 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             it doesn't have to be remembered across a full loop */
         if (HAS_ARG(opcode))
             oparg = NEXTARG();
+
+#ifdef _SYMBEX_INSN_TRACE
+        if (tstate->symbex_insn_buffer != NULL &&
+            (tstate->symbex_insn_buffer->opclass_mask &
+             (1 << _PySymbex_OpcodeTable[opcode].opclass))) {
+            _PySymbexInsnBuffer *insn_buffer = tstate->symbex_insn_buffer;
+            _PySymbexInsnRecord *insn = &insn_buffer->records[insn_buffer->count];
+
+            insn->code_id = co->co_symbex_id;
+            insn->last_inst = f->f_lasti;
+            insn->opcode = opcode;
+            if (++insn_buffer->count == insn_buffer->capacity)
+                insn_buffer->flush(insn_buffer);
+        }
+#endif
     dispatch_opcode:
 #ifdef DYNAMIC_EXECUTION_PROFILE
 #ifdef DXPAIRS
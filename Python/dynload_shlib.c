@@ -3,6 +3,7 @@
 
 #include "Python.h"
 #include "importdl.h"
+#include "symbex.h"
 
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -138,6 +139,10 @@ dl_funcptr _PyImport_GetDynLoadFunc(const char *fqname, const char *shortname,
     }
     if (fp != NULL && nhandles < 128)
         handles[nhandles++].handle = handle;
+#ifdef SYMBEX_INSTRUMENTATION
+    if (_PySymbex_DlopenHook != NULL)
+        _PySymbex_DlopenHook(pathname);
+#endif
     p = (dl_funcptr) dlsym(handle, funcname);
     return p;
 }
@@ -13,6 +13,31 @@
 #include <errno.h>
 #endif
 
+#include "symbex.h"
+
+#ifdef SYMBEX_INSTRUMENTATION
+/* Decodes a digit by range checks, and returns 37 for a non-digit, like
+   _PyLong_DigitValue.  The table lookup forks once per feasible value of a
+   symbolic character; the comparisons below are combined without
+   branching. */
+Py_LOCAL_INLINE(int)
+symbex_digit_value(int c)
+{
+    int is_digit = _SYMBEX_ISDIGIT(c);
+    int is_upper = ((c >= 'A') & (c <= 'Z'));
+    int is_lower = ((c >= 'a') & (c <= 'z'));
+
+    return is_digit * (c - '0') +
+           is_upper * (c - 'A' + 10) +
+           is_lower * (c - 'a' + 10) +
+           (1 - is_digit - is_upper - is_lower) * 37;
+}
+
+#define DIGIT_VALUE(c)  symbex_digit_value(Py_CHARMASK(c))
+#else
+#define DIGIT_VALUE(c)  _PyLong_DigitValue[Py_CHARMASK(c)]
+#endif
+
 /* Static overflow check values for bases 2 through 36.
  * smallmax[base] is the largest unsigned long i such that
  * i * base doesn't overflow unsigned long.
@@ -97,9 +122,12 @@ PyOS_strtoul(register char *str, char **ptr, int base)
     register unsigned long result = 0; /* return value of the function */
     register int c;             /* current input character */
     register int ovlimit;       /* required digits to overflow */
+#ifdef SYMBEX_INSTRUMENTATION
+    register int overflow = 0;  /* overflow seen, tested after the loop */
+#endif
 
     /* skip leading white space */
-    while (*str && isspace(Py_CHARMASK(*str)))
+    while (*str && _SYMBEX_ISSPACE(Py_CHARMASK(*str)))
         ++str;
 
     /* check for leading 0 or 0x for auto-base or base 16 */
@@ -109,7 +137,7 @@ PyOS_strtoul(register char *str, char **ptr, int base)
             ++str;
             if (*str == 'x' || *str == 'X') {
                 /* there must be at least one digit after 0x */
-                if (_PyLong_DigitValue[Py_CHARMASK(str[1])] >= 16) {
+                if (DIGIT_VALUE(str[1]) >= 16) {
                     if (ptr)
                         *ptr = str;
                     return 0;
@@ -118,7 +146,7 @@ PyOS_strtoul(register char *str, char **ptr, int base)
                 base = 16;
             } else if (*str == 'o' || *str == 'O') {
                 /* there must be at least one digit after 0o */
-                if (_PyLong_DigitValue[Py_CHARMASK(str[1])] >= 8) {
+                if (DIGIT_VALUE(str[1]) >= 8) {
                     if (ptr)
                         *ptr = str;
                     return 0;
@@ -127,7 +155,7 @@ PyOS_strtoul(register char *str, char **ptr, int base)
                 base = 8;
             } else if (*str == 'b' || *str == 'B') {
                 /* there must be at least one digit after 0b */
-                if (_PyLong_DigitValue[Py_CHARMASK(str[1])] >= 2) {
+                if (DIGIT_VALUE(str[1]) >= 2) {
                     if (ptr)
                         *ptr = str;
                     return 0;
@@ -147,7 +175,7 @@ PyOS_strtoul(register char *str, char **ptr, int base)
             ++str;
             if (*str == 'b' || *str == 'B') {
                 /* there must be at least one digit after 0b */
-                if (_PyLong_DigitValue[Py_CHARMASK(str[1])] >= 2) {
+                if (DIGIT_VALUE(str[1]) >= 2) {
                     if (ptr)
                         *ptr = str;
                     return 0;
@@ -162,7 +190,7 @@ PyOS_strtoul(register char *str, char **ptr, int base)
             ++str;
             if (*str == 'o' || *str == 'O') {
                 /* there must be at least one digit after 0o */
-                if (_PyLong_DigitValue[Py_CHARMASK(str[1])] >= 8) {
+                if (DIGIT_VALUE(str[1]) >= 8) {
                     if (ptr)
                         *ptr = str;
                     return 0;
@@ -177,7 +205,7 @@ PyOS_strtoul(register char *str, char **ptr, int base)
             ++str;
             if (*str == 'x' || *str == 'X') {
                 /* there must be at least one digit after 0x */
-                if (_PyLong_DigitValue[Py_CHARMASK(str[1])] >= 16) {
+                if (DIGIT_VALUE(str[1]) >= 16) {
                     if (ptr)
                         *ptr = str;
                     return 0;
@@ -203,7 +231,7 @@ PyOS_strtoul(register char *str, char **ptr, int base)
     ovlimit = digitlimit[base];
 
     /* do the conversion until non-digit character encountered */
-    while ((c = _PyLong_DigitValue[Py_CHARMASK(*str)]) < base) {
+    while ((c = DIGIT_VALUE(*str)) < base) {
         if (ovlimit > 0) /* no overflow check required */
             result = result * base + c;
         else { /* requires overflow check */
@@ -212,6 +240,14 @@ PyOS_strtoul(register char *str, char **ptr, int base)
             if (ovlimit < 0) /* guaranteed overflow */
                 goto overflowed;
 
+#ifdef SYMBEX_INSTRUMENTATION
+            /* the checks below would branch on the symbolic result, so
+               record the overflow and test it once after the loop */
+            overflow |= (result > smallmax[base]);
+            result *= base;
+            temp_result = result + c;
+            overflow |= (temp_result < result);
+#else
             /* there could be an overflow */
             /* check overflow just from shifting */
             if (result > smallmax[base])
@@ -223,6 +259,7 @@ PyOS_strtoul(register char *str, char **ptr, int base)
             temp_result = result + c;
             if (temp_result < result)
                 goto overflowed;
+#endif
 
             result = temp_result;
         }
@@ -231,6 +268,11 @@ PyOS_strtoul(register char *str, char **ptr, int base)
         --ovlimit;
     }
 
+#ifdef SYMBEX_INSTRUMENTATION
+    if (overflow)
+        goto overflowed;
+#endif
+
     /* set pointer to point to the last character scanned */
     if (ptr)
         *ptr = str;
@@ -240,7 +282,7 @@ PyOS_strtoul(register char *str, char **ptr, int base)
 overflowed:
     if (ptr) {
         /* spool through remaining digit characters */
-        while (_PyLong_DigitValue[Py_CHARMASK(*str)] < base)
+        while (DIGIT_VALUE(*str) < base)
             ++str;
         *ptr = str;
     }
@@ -260,7 +302,7 @@ PyOS_strtol(char *str, char **ptr, int base)
     unsigned long uresult;
     char sign;
 
-    while (*str && isspace(Py_CHARMASK(*str)))
+    while (*str && _SYMBEX_ISSPACE(Py_CHARMASK(*str)))
         str++;
 
     sign = *str;
@@ -172,6 +172,9 @@ new_threadstate(PyInterpreterState *interp, int init)
         tstate->tick_counter = 0;
         tstate->gilstate_counter = 0;
         tstate->async_exc = NULL;
+#ifdef SYMBEX_INSTRUMENTATION
+        tstate->symbex_insn_buffer = NULL;
+#endif
 #ifdef WITH_THREAD
         tstate->thread_id = PyThread_get_thread_ident();
 #else
@@ -237,6 +240,17 @@ PyThreadState_Clear(PyThreadState *tstate)
     Py_CLEAR(tstate->dict);
     Py_CLEAR(tstate->async_exc);
 
+#ifdef SYMBEX_INSTRUMENTATION
+    if (tstate->symbex_insn_buffer != NULL) {
+        _PySymbexInsnBuffer *insn_buffer = tstate->symbex_insn_buffer;
+
+        tstate->symbex_insn_buffer = NULL;
+        if (insn_buffer->count > 0)
+            insn_buffer->flush(insn_buffer);
+        insn_buffer->release(insn_buffer);
+    }
+#endif
+
     Py_CLEAR(tstate->curexc_type);
     Py_CLEAR(tstate->curexc_value);
     Py_CLEAR(tstate->curexc_traceback);
@@ -2,6 +2,7 @@
 
 #include <Python.h>
 #include <locale.h>
+#include "symbex.h"
 
 /* Case-insensitive string match used for nan and inf detection; t should be
    lower-case.  Returns 1 for a successful match, 0 otherwise. */
@@ -86,6 +87,73 @@ _Py_parse_inf_or_nan(const char *p, char **endptr)
  * Return value: the #gdouble value.
  **/
 
+#ifdef SYMBEX_INSTRUMENTATION
+
+/* Symbolic input policy.  The conversion to a correctly rounded double
+   (bignum arithmetic in _Py_dg_strtod, or the system strtod) branches on
+   the value of every digit, and floating point values cannot be symbolic.
+
+   Instead, the lexical structure of a decimal literal, i.e., the sign,
+   the digit runs, the decimal point and the exponent, is validated first,
+   testing each character with range checks only.  The structure forks at
+   most once per character.  The characters of the literal are then
+   concretized with s2e_concretize(), which constrains the path to the
+   current example of the digits, and the exact conversion runs on concrete
+   data.
+
+   Inputs that are not decimal literals (inf and nan) are left to the
+   regular path. */
+
+static Py_ssize_t
+symbex_float_literal_length(const char *s)
+{
+    const char *p = s, *e;
+    int digits = 0;
+
+    if (*p == '+' || *p == '-')
+        p++;
+    while (_SYMBEX_ISDIGIT(*p)) {
+        p++;
+        digits++;
+    }
+    if (*p == '.') {
+        p++;
+        while (_SYMBEX_ISDIGIT(*p)) {
+            p++;
+            digits++;
+        }
+    }
+    if (digits == 0)
+        return 0;
+
+    /* the exponent is part of the literal only if it has digits */
+    if (*p == 'e' || *p == 'E') {
+        e = p + 1;
+        if (*e == '+' || *e == '-')
+            e++;
+        if (_SYMBEX_ISDIGIT(*e)) {
+            while (_SYMBEX_ISDIGIT(*e))
+                e++;
+            p = e;
+        }
+    }
+    return p - s;
+}
+
+static void
+symbex_prepare_strtod(const char *nptr)
+{
+    Py_ssize_t len = symbex_float_literal_length(nptr);
+
+    if (len > 0 && s2e_is_symbolic(nptr, len))
+        s2e_concretize((char *)nptr, len);
+}
+
+#define SYMBEX_PREPARE_STRTOD(nptr) symbex_prepare_strtod(nptr)
+#else
+#define SYMBEX_PREPARE_STRTOD(nptr)
+#endif /* SYMBEX_INSTRUMENTATION */
+
 #ifndef PY_NO_SHORT_FLOAT_REPR
 
 double
@@ -95,6 +163,7 @@ _PyOS_ascii_strtod(const char *nptr, char **endptr)
     _Py_SET_53BIT_PRECISION_HEADER;
 
     assert(nptr != NULL);
+    SYMBEX_PREPARE_STRTOD(nptr);
     /* Set errno to zero, so that we can distinguish zero results
        and underflows */
     errno = 0;
@@ -135,6 +204,7 @@ _PyOS_ascii_strtod(const char *nptr, char **endptr)
     int negate = 0;
 
     assert(nptr != NULL);
+    SYMBEX_PREPARE_STRTOD(nptr);
 
     fail_pos = NULL;
 
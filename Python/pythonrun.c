@@ -2,6 +2,7 @@
 /* Python interpreter top-level routines, including init/exit */
 
 #include "Python.h"
+#include "symbex.h"
 
 #include "Python-ast.h"
 #undef Yield /* undefine macro conflicting with winbase.h */
@@ -173,6 +174,7 @@ Py_InitializeEx(int install_sigs)
         Py_HashRandomizationFlag = add_flag(Py_HashRandomizationFlag, p);
 
     _PyRandom_Init();
+    _PySymbex_Init();
 
     interp = PyInterpreterState_New();
     if (interp == NULL)
@@ -0,0 +1,421 @@
+/*
+ * Copyright (C) 2014 EPFL.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* Runtime selection of the symbolic execution optimizations */
+
+#include "Python.h"
+#include "symbex.h"
+
+#ifdef SYMBEX_INSTRUMENTATION
+
+/* The configure --enable-symbex-opt options select the defaults */
+#ifdef SYMBEX_OPT_CONCRETIZE_BUFFSIZES
+#define DEFAULT_CONCRBUFF   _SYMBEX_RT_CONCRBUFF
+#else
+#define DEFAULT_CONCRBUFF   0
+#endif
+#ifdef SYMBEX_OPT_DISABLE_INTERNING
+#define DEFAULT_NOINTERN    _SYMBEX_RT_NOINTERN
+#else
+#define DEFAULT_NOINTERN    0
+#endif
+#ifdef SYMBEX_OPT_NEUTRALIZE_HASHES
+#define DEFAULT_HASHES      _SYMBEX_RT_CONST_HASHES
+#else
+#define DEFAULT_HASHES      0
+#endif
+#ifdef SYMBEX_OPT_DISABLE_FAST_PATHS
+#define DEFAULT_NOFASTPATH  _SYMBEX_RT_NOFASTPATH
+#else
+#define DEFAULT_NOFASTPATH  0
+#endif
+
+int _Py_SymbexFlags = DEFAULT_CONCRBUFF | DEFAULT_NOINTERN |
+                      DEFAULT_HASHES | DEFAULT_NOFASTPATH;
+
+static int _Py_SymbexInitialized = 0;
+
+_PySymbexDlopenHook _PySymbex_DlopenHook = NULL;
+
+int _PySymbex_AllocPolicy = _SYMBEX_ALLOC_CLASS;
+
+const char * const _PySymbex_AllocPolicyNames[] = {
+    "example",
+    "bound",
+    "buckets",
+    "class",
+};
+
+Py_ssize_t _PySymbex_AllocCounts[_SYMBEX_ALLOC_POLICY_COUNT];
+
+#define HASH_FLAGS  (_SYMBEX_RT_CONST_HASHES | _SYMBEX_RT_SYM_HASHES)
+#define ALL_FLAGS   (_SYMBEX_RT_CONCRBUFF | _SYMBEX_RT_NOINTERN | \
+                     _SYMBEX_RT_CONST_HASHES | _SYMBEX_RT_NOFASTPATH)
+
+/* Optimization levels, as built by Chef/Makefile.interp before the options
+   were selectable at runtime: each level adds one optimization. */
+static const int level_flags[] = {
+    0,
+    _SYMBEX_RT_CONCRBUFF,
+    _SYMBEX_RT_CONCRBUFF | _SYMBEX_RT_NOINTERN,
+    _SYMBEX_RT_CONCRBUFF | _SYMBEX_RT_NOINTERN | _SYMBEX_RT_CONST_HASHES,
+    ALL_FLAGS,
+};
+
+static const struct {
+    const char *name;
+    int set;        /* flags set by the option */
+    int clear;      /* flags cleared by the option */
+} options[] = {
+    {"concrbuff",   _SYMBEX_RT_CONCRBUFF,       0},
+    {"intern",      _SYMBEX_RT_NOINTERN,        0},
+    {"hashes",      _SYMBEX_RT_CONST_HASHES,    _SYMBEX_RT_SYM_HASHES},
+    {"symhashes",   _SYMBEX_RT_SYM_HASHES,      _SYMBEX_RT_CONST_HASHES},
+    {"fastpath",    _SYMBEX_RT_NOFASTPATH,      0},
+    {"all",         ALL_FLAGS,                  _SYMBEX_RT_SYM_HASHES},
+    {"none",        0,                          ~0},
+    {NULL,          0,                          0}
+};
+
+/* Apply one option token.  Each optimization name enables it, and the same
+   name prefixed by "no" disables it.  Returns 0 on success, -1 if the token
+   is not recognized. */
+static int
+apply_option(const char *opt, size_t len)
+{
+    int i, negate = 0;
+
+    if (len == 1 && opt[0] >= '0' && opt[0] <= '4') {
+        _Py_SymbexFlags = level_flags[opt[0] - '0'];
+        return 0;
+    }
+    /* "alloc=<policy>" selects the size concretization policy, and enables
+       the concretization */
+    if (len > 6 && strncmp(opt, "alloc=", 6) == 0) {
+        for (i = 0; i < _SYMBEX_ALLOC_POLICY_COUNT; i++) {
+            if (strlen(_PySymbex_AllocPolicyNames[i]) != len - 6 ||
+                strncmp(opt + 6, _PySymbex_AllocPolicyNames[i], len - 6) != 0)
+                continue;
+            _PySymbex_AllocPolicy = i;
+            _Py_SymbexFlags |= _SYMBEX_RT_CONCRBUFF;
+            return 0;
+        }
+        return -1;
+    }
+    if (len > 2 && opt[0] == 'n' && opt[1] == 'o' &&
+        !(len == 4 && strncmp(opt, "none", 4) == 0)) {
+        negate = 1;
+        opt += 2;
+        len -= 2;
+    }
+    for (i = 0; options[i].name != NULL; i++) {
+        if (strlen(options[i].name) != len ||
+            strncmp(opt, options[i].name, len) != 0)
+            continue;
+        if (negate) {
+            /* "nohashes" and "nosymhashes" both turn hashing back to
+               normal */
+            _Py_SymbexFlags &= ~options[i].set;
+            if (options[i].set & HASH_FLAGS)
+                _Py_SymbexFlags &= ~HASH_FLAGS;
+        }
+        else {
+            _Py_SymbexFlags &= ~options[i].clear;
+            _Py_SymbexFlags |= options[i].set;
+        }
+        return 0;
+    }
+    return -1;
+}
+
+int
+_PySymbex_SetOptions(const char *opts)
+{
+    const char *end;
+
+    for (; *opts != '\0'; opts = (*end == ',') ? end + 1 : end) {
+        end = strchr(opts, ',');
+        if (end == NULL)
+            end = opts + strlen(opts);
+        if (end == opts)
+            continue;
+        if (apply_option(opts, end - opts) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+void
+_PySymbex_Init(void)
+{
+    const char *env;
+
+    if (_Py_SymbexInitialized)
+        return;
+    _Py_SymbexInitialized = 1;
+
+    /* This must run before the first string is hashed, since the hash mode
+       must not change once hash values are cached in the objects. */
+    env = Py_GETENV("PYTHONSYMBEXOPT");
+    if (env != NULL && _PySymbex_SetOptions(env) < 0)
+        Py_FatalError("PYTHONSYMBEXOPT must be a comma-separated list of an "
+                      "optimization level [0-4] and the options \"concrbuff\", "
+                      "\"intern\", \"hashes\", \"symhashes\", \"fastpath\", "
+                      "\"all\" or \"none\", optionally prefixed by \"no\", "
+                      "and \"alloc=example|bound|buckets|class\"");
+}
+
+/* The size class of a concrete size, rounded up */
+static size_t
+alloc_class_ceiling(size_t size)
+{
+    size_t ceiling = _SYMBEX_ALLOC_SMALL;
+
+    if (size <= _SYMBEX_ALLOC_SMALL) {
+        if (size == 0)
+            return _SYMBEX_ALLOC_ALIGNMENT;
+        return (size + _SYMBEX_ALLOC_ALIGNMENT - 1) &
+            ~(size_t)(_SYMBEX_ALLOC_ALIGNMENT - 1);
+    }
+    while (ceiling < size && ceiling <= PY_SSIZE_T_MAX / 2)
+        ceiling <<= 1;
+    return ceiling < size ? size : ceiling;
+}
+
+/* Fork on the size class of the symbolic `size', and return the upper end
+   of the class of the current path */
+static size_t
+alloc_buckets(size_t size)
+{
+    size_t bucket = _SYMBEX_ALLOC_ALIGNMENT;
+
+    while (size > bucket) {
+        if (bucket > PY_SSIZE_T_MAX / 2) {
+            /* Too large to be allocated anyway */
+            s2e_get_example(&size, sizeof(size));
+            return size;
+        }
+        if (bucket < _SYMBEX_ALLOC_SMALL)
+            bucket += _SYMBEX_ALLOC_ALIGNMENT;
+        else
+            bucket <<= 1;
+    }
+    return bucket;
+}
+
+/* The lower end, excluded, of the size class ending at `ceiling' */
+static size_t
+alloc_class_floor(size_t ceiling)
+{
+    if (ceiling <= _SYMBEX_ALLOC_SMALL)
+        return ceiling - _SYMBEX_ALLOC_ALIGNMENT;
+    return ceiling >> 1;
+}
+
+/* Constrain the symbolic `size' to the size class of its current example,
+   and return the upper end of the class */
+static size_t
+alloc_class(size_t size)
+{
+    size_t example = size;
+    size_t ceiling, floor;
+
+    s2e_get_example(&example, sizeof(example));
+    ceiling = alloc_class_ceiling(example);
+    floor = alloc_class_floor(ceiling);
+
+    /* The first class includes 0 */
+    if (floor == 0)
+        s2e_assume(size <= ceiling);
+    else
+        s2e_assume((size > floor) & (size <= ceiling));
+    return ceiling;
+}
+
+/* The upper bound of the symbolic `size', or (size_t)-1 if it may not fit
+   in the 32 bits that s2e_get_upper_bound() works on */
+static size_t
+alloc_upper_bound(size_t size)
+{
+#if SIZEOF_SIZE_T > 4
+    if (s2e_get_upper_bound((unsigned)(size >> 32)) != 0)
+        return (size_t)-1;
+#endif
+    return s2e_get_upper_bound((unsigned)size);
+}
+
+size_t
+_PySymbex_PrepareAlloc(size_t size)
+{
+    size_t bound;
+
+    switch (_PySymbex_AllocPolicy) {
+    case _SYMBEX_ALLOC_BOUND:
+        bound = alloc_upper_bound(size);
+        if (bound <= MAX_ALLOC_SIZE) {
+            _PySymbex_AllocCounts[_SYMBEX_ALLOC_BOUND]++;
+            return alloc_class_ceiling(bound);
+        }
+        /* fall through */
+    case _SYMBEX_ALLOC_BUCKETS:
+        _PySymbex_AllocCounts[_SYMBEX_ALLOC_BUCKETS]++;
+        return alloc_buckets(size);
+    case _SYMBEX_ALLOC_CLASS:
+        _PySymbex_AllocCounts[_SYMBEX_ALLOC_CLASS]++;
+        return alloc_class(size);
+    default:
+        _PySymbex_AllocCounts[_SYMBEX_ALLOC_EXAMPLE]++;
+        s2e_get_example(&size, sizeof(size));
+        return size;
+    }
+}
+
+Py_ssize_t
+_PySymbex_PrepareVarSize(Py_ssize_t size)
+{
+    Py_ssize_t alloc;
+
+    s2e_assume(size >= 0);
+    alloc = (Py_ssize_t)_PySymbex_PrepareAlloc((size_t)size);
+    /* The other policies allocate for every size of the path already */
+    if (_PySymbex_AllocPolicy == _SYMBEX_ALLOC_EXAMPLE)
+        s2e_assume(size <= alloc);
+    return alloc;
+}
+
+/* The recorded capacities, in an open addressing table with linear probing,
+   keyed by the object address.  The keys are concrete, so the lookups never
+   fork. */
+typedef struct {
+    PyObject *op;
+    Py_ssize_t capacity;
+} capacity_entry;
+
+static capacity_entry *capacity_table = NULL;
+static size_t capacity_mask = 0;
+static size_t capacity_used = 0;
+
+#define CAPACITY_MIN_SIZE   64
+
+static size_t
+capacity_home(PyObject *op)
+{
+    return (size_t)(((Py_uintptr_t)op >> 3) * 2654435761UL) & capacity_mask;
+}
+
+static capacity_entry *
+capacity_lookup(PyObject *op)
+{
+    size_t i = capacity_home(op);
+
+    while (capacity_table[i].op != NULL && capacity_table[i].op != op)
+        i = (i + 1) & capacity_mask;
+    return &capacity_table[i];
+}
+
+/* Returns -1 if out of memory */
+static int
+capacity_grow(void)
+{
+    capacity_entry *old_table = capacity_table;
+    size_t old_size = old_table == NULL ? 0 : capacity_mask + 1;
+    size_t new_size = old_size == 0 ? CAPACITY_MIN_SIZE : old_size * 2;
+    size_t i;
+
+    capacity_table = PyMem_NEW(capacity_entry, new_size);
+    if (capacity_table == NULL) {
+        capacity_table = old_table;
+        return -1;
+    }
+    memset(capacity_table, 0, new_size * sizeof(capacity_entry));
+    capacity_mask = new_size - 1;
+    for (i = 0; i < old_size; i++) {
+        if (old_table[i].op != NULL)
+            *capacity_lookup(old_table[i].op) = old_table[i];
+    }
+    PyMem_FREE(old_table);
+    return 0;
+}
+
+void
+_PySymbex_SetCapacity(PyObject *op, Py_ssize_t capacity)
+{
+    capacity_entry *entry;
+
+    /* Keep the table at most half full.  Without memory, the items past
+       the size are leaked. */
+    if (capacity_table == NULL || 2 * (capacity_used + 1) > capacity_mask) {
+        if (capacity_grow() < 0)
+            return;
+    }
+    entry = capacity_lookup(op);
+    if (entry->op == NULL) {
+        entry->op = op;
+        capacity_used++;
+    }
+    entry->capacity = capacity;
+}
+
+Py_ssize_t
+_PySymbex_TakeCapacity(PyObject *op, Py_ssize_t size)
+{
+    capacity_entry *entry;
+    size_t i, j, home;
+
+    if (capacity_used == 0)
+        return size;
+    entry = capacity_lookup(op);
+    if (entry->op == NULL)
+        return size;
+    size = entry->capacity;
+
+    /* Shift back the entries that probed past the removed one */
+    i = entry - capacity_table;
+    for (j = (i + 1) & capacity_mask; capacity_table[j].op != NULL;
+         j = (j + 1) & capacity_mask) {
+        home = capacity_home(capacity_table[j].op);
+        if (((j - home) & capacity_mask) >= ((j - i) & capacity_mask)) {
+            capacity_table[i] = capacity_table[j];
+            i = j;
+        }
+    }
+    capacity_table[i].op = NULL;
+    capacity_used--;
+    return size;
+}
+
+#else
+
+void
+_PySymbex_Init(void)
+{
+}
+
+int
+_PySymbex_SetOptions(const char *opts)
+{
+    /* Accepted and ignored, so that the same command lines work with a
+       concrete build */
+    return 0;
+}
+
+#endif /* SYMBEX_INSTRUMENTATION */
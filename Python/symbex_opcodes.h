@@ -0,0 +1,261 @@
+/* Generated by Chef/utils/gen_opcode_table.py from Include/opcode.h.
+   Do not edit. */
+
+const _PySymbexOpcodeInfo _PySymbex_OpcodeTable[256] = {
+    {0, _SYMBEX_OP_DEFINED, _SYMBEX_OPCLASS_NONE}, /* STOP_CODE */
+    {-1, _SYMBEX_OP_DEFINED, _SYMBEX_OPCLASS_NONE}, /* POP_TOP */
+    {0, _SYMBEX_OP_DEFINED, _SYMBEX_OPCLASS_NONE}, /* ROT_TWO */
+    {0, _SYMBEX_OP_DEFINED, _SYMBEX_OPCLASS_NONE}, /* ROT_THREE */
+    {1, _SYMBEX_OP_DEFINED, _SYMBEX_OPCLASS_NONE}, /* DUP_TOP */
+    {0, _SYMBEX_OP_DEFINED, _SYMBEX_OPCLASS_NONE}, /* ROT_FOUR */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, _SYMBEX_OP_DEFINED, _SYMBEX_OPCLASS_NONE}, /* NOP */
+    {0, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_ARITH}, /* UNARY_POSITIVE */
+    {0, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_ARITH}, /* UNARY_NEGATIVE */
+    {0, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_TRUTH}, /* UNARY_NOT */
+    {0, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_NONE}, /* UNARY_CONVERT */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_ARITH}, /* UNARY_INVERT */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_ARITH}, /* BINARY_POWER */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_ARITH}, /* BINARY_MULTIPLY */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_ARITH}, /* BINARY_DIVIDE */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_ARITH}, /* BINARY_MODULO */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_ARITH}, /* BINARY_ADD */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_ARITH}, /* BINARY_SUBTRACT */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_SUBSCR}, /* BINARY_SUBSCR */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_ARITH}, /* BINARY_FLOOR_DIVIDE */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_ARITH}, /* BINARY_TRUE_DIVIDE */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_ARITH}, /* INPLACE_FLOOR_DIVIDE */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_ARITH}, /* INPLACE_TRUE_DIVIDE */
+    {0, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_SUBSCR}, /* SLICE+0 */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_SUBSCR}, /* SLICE+1 */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_SUBSCR}, /* SLICE+2 */
+    {-2, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_SUBSCR}, /* SLICE+3 */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {-2, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_SUBSCR}, /* STORE_SLICE+0 */
+    {-3, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_SUBSCR}, /* STORE_SLICE+1 */
+    {-3, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_SUBSCR}, /* STORE_SLICE+2 */
+    {-4, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_SUBSCR}, /* STORE_SLICE+3 */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_SUBSCR}, /* DELETE_SLICE+0 */
+    {-2, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_SUBSCR}, /* DELETE_SLICE+1 */
+    {-2, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_SUBSCR}, /* DELETE_SLICE+2 */
+    {-3, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_SUBSCR}, /* DELETE_SLICE+3 */
+    {-2, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_LOOKUP}, /* STORE_MAP */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_ARITH}, /* INPLACE_ADD */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_ARITH}, /* INPLACE_SUBTRACT */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_ARITH}, /* INPLACE_MULTIPLY */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_ARITH}, /* INPLACE_DIVIDE */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_ARITH}, /* INPLACE_MODULO */
+    {-3, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_SUBSCR}, /* STORE_SUBSCR */
+    {-2, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_SUBSCR}, /* DELETE_SUBSCR */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_ARITH}, /* BINARY_LSHIFT */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_ARITH}, /* BINARY_RSHIFT */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_ARITH}, /* BINARY_AND */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_ARITH}, /* BINARY_XOR */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_ARITH}, /* BINARY_OR */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_ARITH}, /* INPLACE_POWER */
+    {0, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_NONE}, /* GET_ITER */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_NONE}, /* PRINT_EXPR */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_NONE}, /* PRINT_ITEM */
+    {0, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_NONE}, /* PRINT_NEWLINE */
+    {-2, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_NONE}, /* PRINT_ITEM_TO */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_NONE}, /* PRINT_NEWLINE_TO */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_ARITH}, /* INPLACE_LSHIFT */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_ARITH}, /* INPLACE_RSHIFT */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_ARITH}, /* INPLACE_AND */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_ARITH}, /* INPLACE_XOR */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_ARITH}, /* INPLACE_OR */
+    {0, _SYMBEX_OP_DEFINED | _SYMBEX_OP_BRANCH, _SYMBEX_OPCLASS_NONE}, /* BREAK_LOOP */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT | _SYMBEX_OP_VAREFFECT, _SYMBEX_OPCLASS_CALL}, /* WITH_CLEANUP */
+    {1, _SYMBEX_OP_DEFINED, _SYMBEX_OPCLASS_NONE}, /* LOAD_LOCALS */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_BRANCH, _SYMBEX_OPCLASS_NONE}, /* RETURN_VALUE */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_LOOKUP}, /* IMPORT_STAR */
+    {-3, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_CALL}, /* EXEC_STMT */
+    {0, _SYMBEX_OP_DEFINED | _SYMBEX_OP_BRANCH, _SYMBEX_OPCLASS_NONE}, /* YIELD_VALUE */
+    {0, _SYMBEX_OP_DEFINED, _SYMBEX_OPCLASS_NONE}, /* POP_BLOCK */
+    {-3, _SYMBEX_OP_DEFINED | _SYMBEX_OP_BRANCH | _SYMBEX_OP_COND | _SYMBEX_OP_VAREFFECT, _SYMBEX_OPCLASS_NONE}, /* END_FINALLY */
+    {-2, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT, _SYMBEX_OPCLASS_CALL}, /* BUILD_CLASS */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_LOOKUP}, /* STORE_NAME */
+    {0, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_LOOKUP}, /* DELETE_NAME */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT | _SYMBEX_OP_HASARG | _SYMBEX_OP_VAREFFECT, _SYMBEX_OPCLASS_ITER}, /* UNPACK_SEQUENCE */
+    {1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_BRANCH | _SYMBEX_OP_COND | _SYMBEX_OP_CALLOUT | _SYMBEX_OP_VAREFFECT | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_ITER}, /* FOR_ITER */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_NONE}, /* LIST_APPEND */
+    {-2, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_LOOKUP}, /* STORE_ATTR */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_LOOKUP}, /* DELETE_ATTR */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_LOOKUP}, /* STORE_GLOBAL */
+    {0, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_LOOKUP}, /* DELETE_GLOBAL */
+    {0, _SYMBEX_OP_DEFINED | _SYMBEX_OP_HASARG | _SYMBEX_OP_VAREFFECT, _SYMBEX_OPCLASS_NONE}, /* DUP_TOPX */
+    {1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_NONE}, /* LOAD_CONST */
+    {1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_LOOKUP}, /* LOAD_NAME */
+    {1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_HASARG | _SYMBEX_OP_VAREFFECT, _SYMBEX_OPCLASS_NONE}, /* BUILD_TUPLE */
+    {1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_HASARG | _SYMBEX_OP_VAREFFECT, _SYMBEX_OPCLASS_NONE}, /* BUILD_LIST */
+    {1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT | _SYMBEX_OP_HASARG | _SYMBEX_OP_VAREFFECT, _SYMBEX_OPCLASS_LOOKUP}, /* BUILD_SET */
+    {1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_NONE}, /* BUILD_MAP */
+    {0, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_LOOKUP}, /* LOAD_ATTR */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_COMPARE}, /* COMPARE_OP */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_CALL}, /* IMPORT_NAME */
+    {1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_LOOKUP}, /* IMPORT_FROM */
+    {0, _SYMBEX_OP_DEFINED | _SYMBEX_OP_BRANCH | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_NONE}, /* JUMP_FORWARD */
+    {0, _SYMBEX_OP_DEFINED | _SYMBEX_OP_BRANCH | _SYMBEX_OP_COND | _SYMBEX_OP_CALLOUT | _SYMBEX_OP_VAREFFECT | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_TRUTH}, /* JUMP_IF_FALSE_OR_POP */
+    {0, _SYMBEX_OP_DEFINED | _SYMBEX_OP_BRANCH | _SYMBEX_OP_COND | _SYMBEX_OP_CALLOUT | _SYMBEX_OP_VAREFFECT | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_TRUTH}, /* JUMP_IF_TRUE_OR_POP */
+    {0, _SYMBEX_OP_DEFINED | _SYMBEX_OP_BRANCH | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_NONE}, /* JUMP_ABSOLUTE */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_BRANCH | _SYMBEX_OP_COND | _SYMBEX_OP_CALLOUT | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_TRUTH}, /* POP_JUMP_IF_FALSE */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_BRANCH | _SYMBEX_OP_COND | _SYMBEX_OP_CALLOUT | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_TRUTH}, /* POP_JUMP_IF_TRUE */
+    {1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_LOOKUP}, /* LOAD_GLOBAL */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, _SYMBEX_OP_DEFINED | _SYMBEX_OP_BRANCH | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_NONE}, /* CONTINUE_LOOP */
+    {0, _SYMBEX_OP_DEFINED | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_NONE}, /* SETUP_LOOP */
+    {0, _SYMBEX_OP_DEFINED | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_NONE}, /* SETUP_EXCEPT */
+    {0, _SYMBEX_OP_DEFINED | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_NONE}, /* SETUP_FINALLY */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_NONE}, /* LOAD_FAST */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_NONE}, /* STORE_FAST */
+    {0, _SYMBEX_OP_DEFINED | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_NONE}, /* DELETE_FAST */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, _SYMBEX_OP_DEFINED | _SYMBEX_OP_BRANCH | _SYMBEX_OP_CALLOUT | _SYMBEX_OP_HASARG | _SYMBEX_OP_VAREFFECT, _SYMBEX_OPCLASS_NONE}, /* RAISE_VARARGS */
+    {0, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT | _SYMBEX_OP_HASARG | _SYMBEX_OP_VAREFFECT, _SYMBEX_OPCLASS_CALL}, /* CALL_FUNCTION */
+    {0, _SYMBEX_OP_DEFINED | _SYMBEX_OP_HASARG | _SYMBEX_OP_VAREFFECT, _SYMBEX_OPCLASS_NONE}, /* MAKE_FUNCTION */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_HASARG | _SYMBEX_OP_VAREFFECT, _SYMBEX_OPCLASS_NONE}, /* BUILD_SLICE */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_HASARG | _SYMBEX_OP_VAREFFECT, _SYMBEX_OPCLASS_NONE}, /* MAKE_CLOSURE */
+    {1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_NONE}, /* LOAD_CLOSURE */
+    {1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_NONE}, /* LOAD_DEREF */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_NONE}, /* STORE_DEREF */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT | _SYMBEX_OP_HASARG | _SYMBEX_OP_VAREFFECT, _SYMBEX_OPCLASS_CALL}, /* CALL_FUNCTION_VAR */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT | _SYMBEX_OP_HASARG | _SYMBEX_OP_VAREFFECT, _SYMBEX_OPCLASS_CALL}, /* CALL_FUNCTION_KW */
+    {-2, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT | _SYMBEX_OP_HASARG | _SYMBEX_OP_VAREFFECT, _SYMBEX_OPCLASS_CALL}, /* CALL_FUNCTION_VAR_KW */
+    {4, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_CALL}, /* SETUP_WITH */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, _SYMBEX_OP_DEFINED | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_NONE}, /* EXTENDED_ARG */
+    {-1, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_LOOKUP}, /* SET_ADD */
+    {-2, _SYMBEX_OP_DEFINED | _SYMBEX_OP_CALLOUT | _SYMBEX_OP_HASARG, _SYMBEX_OPCLASS_LOOKUP}, /* MAP_ADD */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+    {0, 0, _SYMBEX_OPCLASS_NONE}, /* unused */
+};